@@ -215,6 +215,18 @@
 
 /** @} */
 
+/**
+ * @addtogroup EQOS-RX-BURST Rx burst processing
+ *
+ * @brief Rx packets are handed to OSD and the ring is refilled in bursts.
+ * @{
+ */
+/** Max. number of Rx packets handed to OSD at once */
+#define OSI_RX_PKT_BURST	16U
+/** Min. number of consumed Rx descriptors for a ring refill */
+#define OSI_RX_REFILL_THRESHOLD	16U
+/** @} */
+
 #ifndef OSI_STRIPPED_LIB
 /**
  * @addtogroup RSS-HASH type
@@ -337,8 +349,8 @@ struct osi_rx_swcx {
 };
 
 /**
- * @brief - Received packet context. This is a single instance
- * and it is reused for all rx packets.
+ * @brief - Received packet context. One instance per packet of
+ * an Rx burst, reused for all rx bursts.
  */
 struct osi_rx_pkt_cx {
 	/** Bit map which holds the features that rx packets supports */
@@ -374,8 +386,10 @@ struct osi_rx_ring {
 	nveu32_t cur_rx_idx;
 	/** Descriptor index for descriptor re-allocation */
 	nveu32_t refill_idx;
-	/** Receive packet context */
-	struct osi_rx_pkt_cx rx_pkt_cx;
+	/** Receive packet contexts of the current burst */
+	struct osi_rx_pkt_cx rx_pkt_cx[OSI_RX_PKT_BURST];
+	/** Rx software contexts of the current burst */
+	struct osi_rx_swcx *rx_pkt_swcx[OSI_RX_PKT_BURST];
 };
 
 /**
@@ -484,6 +498,8 @@ struct osi_tx_ring {
 	struct osi_txdone_pkt_cx txdone_pkt_cx;
 	/** Number of packets or frames transmitted */
 	nveu32_t frame_cnt;
+	/** Per channel tx_frames, overrides osi_dma->tx_frames if non zero */
+	nveu32_t tx_frames;
 	/** flag to skip memory barrier */
 	nveu32_t skip_dmb;
 };
@@ -527,6 +543,13 @@ struct osd_dma_ops {
 			       nveu32_t chan, nveu32_t dma_buf_len,
 			       const struct osi_rx_pkt_cx *rx_pkt_cx,
 			       struct osi_rx_swcx *rx_swcx);
+	/** DMA receive packet burst callback, used instead of
+	 * receive_packet when set */
+	void (*receive_packets)(void *priv, struct osi_rx_ring *rx_ring,
+				nveu32_t chan, nveu32_t dma_buf_len,
+				const struct osi_rx_pkt_cx *rx_pkt_cx,
+				struct osi_rx_swcx *const *rx_swcx,
+				nveu32_t count);
 	/** RX buffer reallocation callback */
 	void (*realloc_buf)(void *priv, struct osi_rx_ring *rx_ring,
 			    nveu32_t chan);
@@ -852,9 +875,11 @@ nve32_t osi_process_tx_completions(struct osi_dma_priv_data *osi_dma,
  *    - If rx buffer is reserve buffer, reallocate receive buffer and
  *      read next descriptor.
  *    - Get the length from Rx descriptor
- *    - Invokes OSD layer to deliver the packet to network stack.
- *    - Re-allocate the receive buffers, populate Rx descriptor and
- *      handover to DMA.
+ *    - Collects up to OSI_RX_PKT_BURST packets and invokes OSD layer
+ *      to deliver them to network stack.
+ *    - Once OSI_RX_REFILL_THRESHOLD descriptors are consumed, invokes
+ *      OSD layer once to re-allocate the receive buffers, populate Rx
+ *      descriptors and handover to DMA.
  *
  * @param[in, out] osi_dma: OSI DMA private data structure.
  * @param[in] chan: Rx DMA channel number. Max OSI_EQOS_MAX_NUM_CHANS.
@@ -1114,6 +1139,40 @@ nveu32_t osi_is_mac_enabled(struct osi_dma_priv_data *const osi_dma);
 nve32_t osi_handle_dma_intr(struct osi_dma_priv_data *osi_dma,
 			    nveu32_t chan, nveu32_t tx_rx, nveu32_t en_dis);
 
+/**
+ * @brief osi_config_rx_riwt - Update Rx interrupt watchdog timer of a channel
+ *
+ * @note
+ * Algorithm:
+ *  - Reprograms the RWT field of the DMA channel Rx watchdog register
+ *    at run time. RWTU is left as programmed by osi_hw_dma_init().
+ *
+ * @param[in] osi_dma: OSI DMA private data structure.
+ * @param[in] chan: DMA Rx channel number.
+ * @param[in] rx_riwt: Rx interrupt watchdog timeout in usec.
+ *
+ * @pre
+ *  - DMA HW init need to be completed successfully, see osi_hw_dma_init
+ *  - osi_dma->use_riwt need to be OSI_ENABLE
+ *
+ * @usage
+ * - Allowed context for the API call
+ *  - Interrupt handler: No
+ *  - Signal handler: No
+ *  - Thread safe: No
+ *  - Async/Sync: Sync
+ *  - Required Privileges: None
+ * - API Group:
+ *  - Initialization: No
+ *  - Run time: Yes
+ *  - De-initialization: No
+ *
+ * @retval 0 on success
+ * @retval -1 on failure.
+ */
+nve32_t osi_config_rx_riwt(struct osi_dma_priv_data *osi_dma,
+			   nveu32_t chan, nveu32_t rx_riwt);
+
 #ifdef OSI_DEBUG
 /**
  * @brief osi_dma_ioctl - OSI DMA IOCTL
@@ -303,7 +303,8 @@ nve32_t osi_init_dma_ops(struct osi_dma_priv_data *osi_dma)
 
 	if (osi_dma->is_ethernet_server != OSI_ENABLE) {
 		if ((osi_dma->osd_ops.transmit_complete == OSI_NULL) ||
-		    (osi_dma->osd_ops.receive_packet == OSI_NULL) ||
+		    ((osi_dma->osd_ops.receive_packet == OSI_NULL) &&
+		     (osi_dma->osd_ops.receive_packets == OSI_NULL)) ||
 		    (osi_dma->osd_ops.ops_log == OSI_NULL) ||
 #ifdef OSI_DEBUG
 		    (osi_dma->osd_ops.printf == OSI_NULL) ||
@@ -393,11 +394,32 @@ static inline void start_dma(const struct osi_dma_priv_data *const osi_dma, nveu
 	osi_writel(val, (nveu8_t *)osi_dma->base + rx_dma_reg[osi_dma->mac]);
 }
 
+/**
+ * @brief rx_wdt_rwt_val - Rx watchdog timer count for a RIWT value
+ *
+ * @param[in] osi_dma: OSI DMA private data structure.
+ * @param[in] rx_riwt: Rx interrupt watchdog timeout in usec.
+ *
+ * @retval RWT field value in units of the programmed RWTU.
+ */
+static inline nveu32_t rx_wdt_rwt_val(const struct osi_dma_priv_data *const osi_dma,
+				      nveu32_t rx_riwt)
+{
+	nveu32_t riwt = rx_riwt & 0xFFFU;
+	const nveu32_t rwt_val[2] = {
+		(((riwt * (EQOS_AXI_CLK_FREQ / OSI_ONE_MEGA_HZ)) /
+		  EQOS_DMA_CHX_RX_WDT_RWTU) & EQOS_DMA_CHX_RX_WDT_RWT_MASK),
+		(((riwt * ((nveu32_t)MGBE_AXI_CLK_FREQ / OSI_ONE_MEGA_HZ)) /
+		 MGBE_DMA_CHX_RX_WDT_RWTU) & MGBE_DMA_CHX_RX_WDT_RWT_MASK)
+	};
+
+	return rwt_val[osi_dma->mac];
+}
+
 static void init_dma_channel(const struct osi_dma_priv_data *const osi_dma,
 			     nveu32_t dma_chan)
 {
 	nveu32_t chan = dma_chan & 0xFU;
-	nveu32_t riwt = osi_dma->rx_riwt & 0xFFFU;
 	const nveu32_t intr_en_reg[2] = {
 		EQOS_DMA_CHX_INTR_ENA(chan),
 		MGBE_DMA_CHX_INTR_ENA(chan)
@@ -427,12 +449,6 @@ static void init_dma_channel(const struct osi_dma_priv_data *const osi_dma,
 		EQOS_DMA_CHX_RX_CTRL_RXPBL_RECOMMENDED,
 		((MGBE_RXQ_SIZE / osi_dma->num_dma_chans) / 2U)
 	};
-	const nveu32_t rwt_val[2] = {
-		(((riwt * (EQOS_AXI_CLK_FREQ / OSI_ONE_MEGA_HZ)) /
-		  EQOS_DMA_CHX_RX_WDT_RWTU) & EQOS_DMA_CHX_RX_WDT_RWT_MASK),
-		(((riwt * ((nveu32_t)MGBE_AXI_CLK_FREQ / OSI_ONE_MEGA_HZ)) /
-		 MGBE_DMA_CHX_RX_WDT_RWTU) & MGBE_DMA_CHX_RX_WDT_RWT_MASK)
-	};
 	const nveu32_t rwtu_val[2] = {
 		EQOS_DMA_CHX_RX_WDT_RWTU_512_CYCLE,
 		MGBE_DMA_CHX_RX_WDT_RWTU_2048_CYCLE
@@ -504,7 +520,7 @@ static void init_dma_channel(const struct osi_dma_priv_data *const osi_dma,
 	    (osi_dma->rx_riwt < UINT_MAX)) {
 		val = osi_readl((nveu8_t *)osi_dma->base + rx_wdt_reg[osi_dma->mac]);
 		val &= ~DMA_CHX_RX_WDT_RWT_MASK;
-		val |= rwt_val[osi_dma->mac];
+		val |= rx_wdt_rwt_val(osi_dma, osi_dma->rx_riwt);
 		osi_writel(val, (nveu8_t *)osi_dma->base + rx_wdt_reg[osi_dma->mac]);
 
 		val = osi_readl((nveu8_t *)osi_dma->base + rx_wdt_reg[osi_dma->mac]);
@@ -718,6 +734,44 @@ fail:
 	return ret;
 }
 
+nve32_t osi_config_rx_riwt(struct osi_dma_priv_data *osi_dma,
+			   nveu32_t chan, nveu32_t rx_riwt)
+{
+	struct dma_local *l_dma = (struct dma_local *)(void *)osi_dma;
+	nveu32_t rx_wdt_reg;
+	nveu32_t val;
+	nve32_t ret = 0;
+
+	if (dma_validate_args(osi_dma, l_dma) < 0) {
+		ret = -1;
+		goto fail;
+	}
+
+	if (validate_dma_chan_num(osi_dma, chan) < 0) {
+		ret = -1;
+		goto fail;
+	}
+
+	/* RWTU is only programmed when RIWT is enabled at DMA init */
+	if ((osi_dma->use_riwt != OSI_ENABLE) || (rx_riwt == 0U)) {
+		OSI_DMA_ERR(osi_dma->osd, OSI_LOG_ARG_INVALID,
+			    "dma: RIWT is not enabled\n", rx_riwt);
+		ret = -1;
+		goto fail;
+	}
+
+	rx_wdt_reg = (osi_dma->mac == OSI_MAC_HW_MGBE) ?
+		     MGBE_DMA_CHX_RX_WDT(chan) : EQOS_DMA_CHX_RX_WDT(chan);
+
+	val = osi_readl((nveu8_t *)osi_dma->base + rx_wdt_reg);
+	val &= ~DMA_CHX_RX_WDT_RWT_MASK;
+	val |= rx_wdt_rwt_val(osi_dma, rx_riwt);
+	osi_writel(val, (nveu8_t *)osi_dma->base + rx_wdt_reg);
+
+fail:
+	return ret;
+}
+
 nveu32_t osi_get_refill_rx_desc_cnt(const struct osi_dma_priv_data *const osi_dma,
 				    nveu32_t chan)
 {
@@ -44,7 +44,6 @@ static struct desc_ops d_ops[MAX_MAC_IP_TYPES];
  * @param[in] more_data_avail: Pointer to more data available flag. OSI fills
  *         this flag if more rx packets available to read(1) or not(0).
  * @param[out] rx_ring: OSI DMA channel Rx ring
- * @param[out] rx_pkt_cx: OSI DMA receive packet context
  *
  * @note
  * API Group:
@@ -59,8 +58,7 @@ static inline nve32_t validate_rx_completions_arg(
 					      struct osi_dma_priv_data *osi_dma,
 					      nveu32_t chan,
 					      const nveu32_t *const more_data_avail,
-					      struct osi_rx_ring **rx_ring,
-					      struct osi_rx_pkt_cx **rx_pkt_cx)
+					      struct osi_rx_ring **rx_ring)
 {
 	const struct dma_local *const l_dma = (struct dma_local *)(void *)osi_dma;
 	nve32_t ret = 0;
@@ -80,11 +78,11 @@ static inline nve32_t validate_rx_completions_arg(
 		ret = -1;
 		goto fail;
 	}
-	*rx_pkt_cx = &(*rx_ring)->rx_pkt_cx;
-	if (osi_unlikely(*rx_pkt_cx == OSI_NULL)) {
+
+	if (osi_unlikely((osi_dma->osd_ops.receive_packets == OSI_NULL) &&
+			 (osi_dma->osd_ops.receive_packet == OSI_NULL))) {
 		OSI_DMA_ERR(osi_dma->osd, OSI_LOG_ARG_INVALID,
-			    "validate_input_rx_completions: Invalid pointers\n",
-			    0ULL);
+			    "dma_txrx: Invalid function pointer\n", 0ULL);
 		ret = -1;
 		goto fail;
 	}
@@ -93,6 +91,53 @@ fail:
 	return ret;
 }
 
+/**
+ * @brief rx_pkt_burst_flush - Hand the collected Rx packets over to OSD
+ *
+ * @note
+ * Algorithm:
+ *  - Invokes OSD receive_packets() once for the whole burst, or
+ *    receive_packet() per packet if OSD does not take bursts.
+ *
+ * @param[in] osi_dma: OSI DMA private data structure.
+ * @param[in] rx_ring: OSI DMA channel Rx ring
+ * @param[in] chan: Rx DMA channel number
+ * @param[in, out] count: Number of packets in the burst, reset to 0.
+ *
+ * @note
+ * API Group:
+ * - Initialization: No
+ * - Run time: Yes
+ * - De-initialization: No
+ */
+static inline void rx_pkt_burst_flush(struct osi_dma_priv_data *osi_dma,
+				      struct osi_rx_ring *rx_ring,
+				      nveu32_t chan, nveu32_t *count)
+{
+	nveu32_t i;
+
+	if (*count == 0U) {
+		return;
+	}
+
+	if (osi_dma->osd_ops.receive_packets != OSI_NULL) {
+		osi_dma->osd_ops.receive_packets(osi_dma->osd, rx_ring, chan,
+						 osi_dma->rx_buf_len,
+						 rx_ring->rx_pkt_cx,
+						 rx_ring->rx_pkt_swcx, *count);
+	} else {
+		for (i = 0U; i < *count; i++) {
+			osi_dma->osd_ops.receive_packet(osi_dma->osd, rx_ring,
+							chan,
+							osi_dma->rx_buf_len,
+							&rx_ring->rx_pkt_cx[i],
+							rx_ring->rx_pkt_swcx[i]);
+		}
+	}
+
+	*count = 0U;
+}
+
 nve32_t osi_process_rx_completions(struct osi_dma_priv_data *osi_dma,
 				   nveu32_t chan, nve32_t budget,
 				   nveu32_t *more_data_avail)
@@ -103,7 +148,8 @@ nve32_t osi_process_rx_completions(struct osi_dma_priv_data *osi_dma,
 	struct osi_rx_swcx *rx_swcx = OSI_NULL;
 	struct osi_rx_swcx *ptp_rx_swcx = OSI_NULL;
 	struct osi_rx_desc *context_desc = OSI_NULL;
-	nveu32_t ip_type = osi_dma->mac;
+	const struct desc_ops *const ops = &d_ops[osi_dma->mac];
+	nveu32_t burst = 0U;
 	nve32_t received = 0;
 #ifndef OSI_STRIPPED_LIB
 	nve32_t received_resv = 0;
@@ -111,7 +157,7 @@ nve32_t osi_process_rx_completions(struct osi_dma_priv_data *osi_dma,
 	nve32_t ret = 0;
 
 	ret = validate_rx_completions_arg(osi_dma, chan, more_data_avail,
-					  &rx_ring, &rx_pkt_cx);
+					  &rx_ring);
 	if (osi_unlikely(ret < 0)) {
 		received = -1;
 		goto fail;
@@ -139,7 +185,12 @@ nve32_t osi_process_rx_completions(struct osi_dma_priv_data *osi_dma,
 			break;
 		}
 		rx_swcx = rx_ring->rx_swcx + rx_ring->cur_rx_idx;
-		osi_memset(rx_pkt_cx, 0U, sizeof(*rx_pkt_cx));
+		rx_pkt_cx = &rx_ring->rx_pkt_cx[burst];
+		/* Only flags and rxcsum are accumulated, other fields are
+		 * either always written or only valid along with a flag.
+		 */
+		rx_pkt_cx->flags = 0U;
+		rx_pkt_cx->rxcsum = 0U;
 #if defined OSI_DEBUG && !defined OSI_STRIPPED_LIB
 		if (osi_dma->enable_desc_dump == 1U) {
 			desc_dump(osi_dma, rx_ring->cur_rx_idx,
@@ -156,6 +207,10 @@ nve32_t osi_process_rx_completions(struct osi_dma_priv_data *osi_dma,
 			rx_swcx->buf_phy_addr  = 0;
 			/* Reservered buffer used */
 			received_resv++;
+			/* Refill walks up to cur_rx_idx, so the buffers of
+			 * the pending burst have to be handed over first.
+			 */
+			rx_pkt_burst_flush(osi_dma, rx_ring, chan, &burst);
 			if (osi_dma->osd_ops.realloc_buf != OSI_NULL) {
 				osi_dma->osd_ops.realloc_buf(osi_dma->osd,
 							     rx_ring, chan);
@@ -204,24 +259,24 @@ nve32_t osi_process_rx_completions(struct osi_dma_priv_data *osi_dma,
 				 */
 				rx_pkt_cx->flags &= ~OSI_PKT_CX_VALID;
 #ifndef OSI_STRIPPED_LIB
-				d_ops[ip_type].update_rx_err_stats(rx_desc,
+				ops->update_rx_err_stats(rx_desc,
 						&osi_dma->pkt_err_stats);
 #endif /* !OSI_STRIPPED_LIB */
 			}
 
 			/* Check if COE Rx checksum is valid */
-			d_ops[ip_type].get_rx_csum(rx_desc, rx_pkt_cx);
+			ops->get_rx_csum(rx_desc, rx_pkt_cx);
 
 #ifndef OSI_STRIPPED_LIB
 			/* Get Rx VLAN from descriptor */
-			d_ops[ip_type].get_rx_vlan(rx_desc, rx_pkt_cx);
+			ops->get_rx_vlan(rx_desc, rx_pkt_cx);
 
 			/* get_rx_hash for RSS */
-			d_ops[ip_type].get_rx_hash(rx_desc, rx_pkt_cx);
+			ops->get_rx_hash(rx_desc, rx_pkt_cx);
 #endif /* !OSI_STRIPPED_LIB */
 			context_desc = rx_ring->rx_desc + rx_ring->cur_rx_idx;
 			/* Get rx time stamp */
-			ret = d_ops[ip_type].get_rx_hwstamp(osi_dma, rx_desc,
+			ret = ops->get_rx_hwstamp(osi_dma, rx_desc,
 						  context_desc, rx_pkt_cx);
 			if (ret == 0) {
 				ptp_rx_swcx = rx_ring->rx_swcx +
@@ -245,29 +300,37 @@ nve32_t osi_process_rx_completions(struct osi_dma_priv_data *osi_dma,
 				 */
 				INCR_RX_DESC_INDEX(rx_ring->cur_rx_idx, osi_dma->rx_ring_sz);
 			}
-			if (osi_likely(osi_dma->osd_ops.receive_packet !=
-				       OSI_NULL)) {
-				osi_dma->osd_ops.receive_packet(osi_dma->osd,
-							    rx_ring, chan,
-							    osi_dma->rx_buf_len,
-							    rx_pkt_cx, rx_swcx);
-			} else {
-				OSI_DMA_ERR(osi_dma->osd, OSI_LOG_ARG_INVALID,
-					    "dma_txrx: Invalid function pointer\n",
-					    0ULL);
-				received = -1;
-				goto fail;
+
+			/* Queue the packet, OSD gets it with the burst */
+			rx_ring->rx_pkt_swcx[burst] = rx_swcx;
+			burst++;
+			if (burst == OSI_RX_PKT_BURST) {
+				rx_pkt_burst_flush(osi_dma, rx_ring, chan,
+						   &burst);
 			}
 		}
+		received++;
+	}
+
+	rx_pkt_burst_flush(osi_dma, rx_ring, chan, &burst);
+
 #ifndef OSI_STRIPPED_LIB
-		osi_dma->dstats.q_rx_pkt_n[chan] =
-			osi_update_stats_counter(
-					osi_dma->dstats.q_rx_pkt_n[chan],
-					1UL);
-		osi_dma->dstats.rx_pkt_n =
-			osi_update_stats_counter(osi_dma->dstats.rx_pkt_n, 1UL);
+	osi_dma->dstats.q_rx_pkt_n[chan] =
+		osi_update_stats_counter(osi_dma->dstats.q_rx_pkt_n[chan],
+					 (nveu64_t)received);
+	osi_dma->dstats.rx_pkt_n =
+		osi_update_stats_counter(osi_dma->dstats.rx_pkt_n,
+					 (nveu64_t)received);
 #endif /* !OSI_STRIPPED_LIB */
-		received++;
+
+	/* Refill the consumed descriptors in one go, so that the Rx tail
+	 * pointer is written once per call instead of once per packet
+	 * batch delivered by OSD.
+	 */
+	if ((osi_dma->osd_ops.realloc_buf != OSI_NULL) &&
+	    (osi_get_refill_rx_desc_cnt(osi_dma, chan) >=
+	     OSI_RX_REFILL_THRESHOLD)) {
+		osi_dma->osd_ops.realloc_buf(osi_dma->osd, rx_ring, chan);
 	}
 
 #ifndef OSI_STRIPPED_LIB
@@ -999,6 +1062,8 @@ nve32_t hw_transmit(struct osi_dma_priv_data *osi_dma,
 		MGBE_DMA_CHX_TDTLP(chan)
 	};
 	nve32_t cntx_desc_consumed;
+	nveu32_t tx_frames = (tx_ring->tx_frames != 0U) ?
+			     tx_ring->tx_frames : osi_dma->tx_frames;
 	nveu32_t pkt_id = 0x0U;
 	nveu32_t desc_cnt = 0U;
 	nveu64_t tailptr;
@@ -1115,9 +1180,9 @@ nve32_t hw_transmit(struct osi_dma_priv_data *osi_dma,
 	if (tx_ring->frame_cnt < UINT_MAX) {
 		tx_ring->frame_cnt++;
 	} else if ((osi_dma->use_tx_frames == OSI_ENABLE) &&
-		   ((tx_ring->frame_cnt % osi_dma->tx_frames) < UINT_MAX)) {
+		   ((tx_ring->frame_cnt % tx_frames) < UINT_MAX)) {
 		/* make sure count for tx_frame interrupt logic is retained */
-		tx_ring->frame_cnt = (tx_ring->frame_cnt % osi_dma->tx_frames)
+		tx_ring->frame_cnt = (tx_ring->frame_cnt % tx_frames)
 					+ 1U;
 	} else {
 		tx_ring->frame_cnt = 1U;
@@ -1131,7 +1196,7 @@ nve32_t hw_transmit(struct osi_dma_priv_data *osi_dma,
 		 * can be enabled only along with tx_usecs.
 		 */
 		if (osi_dma->use_tx_frames == OSI_ENABLE) {
-			if ((tx_ring->frame_cnt % osi_dma->tx_frames) ==
+			if ((tx_ring->frame_cnt % tx_frames) ==
 			    OSI_NONE) {
 				last_desc->tdes2 |= TDES2_IOC;
 			}
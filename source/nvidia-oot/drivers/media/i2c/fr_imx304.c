@@ -58,8 +58,6 @@
 #define IMX304_CAMERA_CID_TG_DELAY_FRAME		(IMX304_CAMERA_CID_BASE + 3)
 
 
-static struct mutex serdes_lock__;
-
 static const struct of_device_id imx304_of_match[] = {
 	{ .compatible = "framos,imx304",},
 	{ },
@@ -158,14 +156,17 @@ struct imx304 {
 	struct camera_common_data	*s_data;
 	struct tegracam_device		*tc_dev;
 	struct lifmd_lvds2mipi_1	*lifmd_lvds2mipi_1;
+	struct fr_table_stats		table_stats;
+	struct fr_table_cache		table_cache;
+	struct fr_stop_ctx		stream_stop;
+	struct fr_ctrl_blob		ctrl_blob;
+	struct tegracam_ctrl_ops	ctrl_ops;
 };
 
 static const struct regmap_config sensor_regmap_config = {
 	.reg_bits = 16,
 	.val_bits = 8,
 	.cache_type = REGCACHE_RBTREE,
-	.use_single_read = true,
-	.use_single_write = true,
 };
 
 static inline int imx304_read_reg(struct camera_common_data *s_data,
@@ -197,86 +198,30 @@ static int imx304_write_reg(struct camera_common_data *s_data,
 static int imx304_read_buffered_reg(struct camera_common_data *s_data,
 			u16 addr_low, u8 number_of_registers, u64 *val)
 {
-	struct device *dev = s_data->dev;
-	int err, i;
-	u8 reg;
-	*val = 0;
-
-	if (!s_data->group_hold_active) {
-		err = imx304_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: error setting register hold\n",
-								__func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx304_read_reg(s_data, addr_low + i, &reg);
-		*val += reg << (i * 8);
-		if (err) {
-			dev_err(dev, "%s: error reading buffered registers\n",
-								__func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx304_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: error unsetting register hold\n",
-								__func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_read_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx304_write_buffered_reg(struct camera_common_data *s_data,
 				u16 addr_low, u8 number_of_registers, u64 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx304_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx304_write_reg(s_data, addr_low + i,
-						(u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n",
-								__func__);
-			return err;
-		}
-	}
+	struct imx304 *priv = (struct imx304 *)s_data->priv;
 
-	if (!s_data->group_hold_active) {
-		err = imx304_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-			return err;
-		}
-	}
+	if (priv->ctrl_blob.blob)
+		return fr_blob_buffered_reg(&priv->ctrl_blob, REGHOLD,
+			addr_low, number_of_registers, val, false);
 
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx304_write_table(struct imx304 *priv, const imx304_reg table[])
 {
 	struct camera_common_data *s_data = priv->s_data;
 
-	return regmap_util_write_table_8(s_data->regmap,
-					table,
-					NULL, 0,
-					IMX304_TABLE_WAIT_MS,
-					IMX304_TABLE_END);
+	return fr_write_table_cached(s_data->regmap, &priv->table_cache,
+				table, IMX304_TABLE_WAIT_MS, IMX304_TABLE_END,
+				&priv->table_stats);
 }
 
 static int imx304_set_group_hold(struct tegracam_device *tc_dev, bool val)
@@ -712,6 +657,7 @@ static int imx304_power_off(struct camera_common_data *s_data)
 	}
 
 power_off_done:
+	fr_table_cache_invalidate(s_data->regmap, &priv->table_cache);
 	pw->state = SWITCH_OFF;
 	mutex_unlock(&priv->pw_mutex);
 
@@ -932,9 +878,15 @@ static int imx304_set_mode(struct tegracam_device *tc_dev)
 	struct imx304 *priv = (struct imx304 *)tegracam_get_privdata(tc_dev);
 	struct camera_common_data *s_data = tc_dev->s_data;
 	struct device *dev = tc_dev->dev;
+	struct fr_ctrl_snapshot ctrls;
 	struct v4l2_ctrl *ctrl;
 	int err;
 
+	fr_table_stats_begin(&priv->table_stats);
+	fr_stream_settle(&priv->stream_stop);
+	fr_table_cache_begin_mode(&priv->table_cache);
+	fr_ctrl_snapshot_take(tc_dev, &ctrls);
+
 	err = lifmd_lvds2mipi_1_set_readout_mode(priv->lifmd_lvds2mipi_1, s_data);
 	if (err)
 		goto fail;
@@ -953,8 +905,7 @@ static int imx304_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx304_set_operation_mode(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-				TEGRA_CAMERA_CID_OPERATION_MODE, CURRENT));
+	err = imx304_set_operation_mode(tc_dev, ctrls.operation_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to set operation mode\n", __func__);
 		return err;
@@ -1015,8 +966,7 @@ static int imx304_set_mode(struct tegracam_device *tc_dev)
 	if (err)
 		goto fail;
 
-	err = imx304_set_test_pattern(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-					TEGRA_CAMERA_CID_TEST_PATTERN, CURRENT));
+	err = imx304_set_test_pattern(tc_dev, ctrls.test_pattern);
 	if (err) {
 		dev_err(dev, "%s: unable to set Test pattern\n", __func__);
 		return err;
@@ -1037,6 +987,8 @@ static int imx304_set_mode(struct tegracam_device *tc_dev)
 	if (err)
 		goto fail;
 
+	fr_table_cache_end_mode(&priv->table_cache);
+	fr_table_stats_end(dev, &priv->table_stats, s_data->mode);
 	dev_dbg(dev, "%s: set mode %u\n", __func__, s_data->mode);
 
 	return 0;
@@ -1094,6 +1046,8 @@ static int imx304_stop_streaming(struct tegracam_device *tc_dev)
 	struct device *dev = tc_dev->dev;
 	int err;
 
+	fr_stream_stop_begin(&priv->stream_stop);
+
 	if (!strcmp(s_data->pdata->gmsl, "gmsl")) {
 		/* disable serdes streaming */
 		max96792_stop_streaming(priv->s_data->dser_dev, dev);
@@ -1108,8 +1062,8 @@ static int imx304_stop_streaming(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
-	usleep_range(priv->frame_length * priv->line_time / IMX304_K_FACTOR,
-		priv->frame_length * priv->line_time / IMX304_K_FACTOR + 1000);
+	fr_stream_stop_end(&priv->stream_stop,
+		priv->frame_length * priv->line_time / IMX304_K_FACTOR);
 
 	return 0;
 }
@@ -1195,7 +1149,7 @@ static int imx304_gmsl_serdes_setup(struct imx304 *priv)
 
 	dev_dbg(dev, "%s++\n", __func__);
 
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
@@ -1240,20 +1194,20 @@ static int imx304_gmsl_serdes_setup(struct imx304 *priv)
 	}
 
 error:
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 	return err;
 }
 
 static void imx304_gmsl_serdes_reset(struct imx304 *priv)
 {
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96793_reset_control(priv->s_data->ser_dev);
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
 	max96792_power_off(priv->s_data->dser_dev, &priv->s_data->g_ctx);
 
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 }
 
 static int imx304_board_setup(struct imx304 *priv)
@@ -1430,7 +1384,6 @@ static int imx304_board_setup(struct imx304 *priv)
 
 		priv->s_data->g_ctx.s_dev = dev;
 
-		mutex_init(&serdes_lock__);
 
 		err = max96793_sdev_pair(priv->s_data->ser_dev,
 						&priv->s_data->g_ctx);
@@ -1513,13 +1466,52 @@ static const struct v4l2_subdev_internal_ops imx304_subdev_internal_ops = {
 	.open = imx304_open,
 };
 
-static struct tegracam_ctrl_ops imx304_ctrl_ops = {
+static int imx304_set_group_hold_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, bool val)
+{
+	struct imx304 *priv = (struct imx304 *)tc_dev->priv;
+
+	return fr_set_group_hold_ex(&priv->ctrl_blob, blob, REGHOLD, val);
+}
+
+static int imx304_set_gain_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx304 *priv = (struct imx304 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx304_set_gain, val);
+}
+
+static int imx304_set_exposure_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx304 *priv = (struct imx304 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx304_set_exposure, val);
+}
+
+static int imx304_set_frame_rate_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx304 *priv = (struct imx304 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx304_set_frame_rate, val);
+}
+
+static const struct tegracam_ctrl_ops imx304_ctrl_ops = {
 	.numctrls = ARRAY_SIZE(ctrl_cid_list),
 	.ctrl_cid_list = ctrl_cid_list,
 	.set_gain = imx304_set_gain,
 	.set_exposure = imx304_set_exposure,
 	.set_frame_rate = imx304_set_frame_rate,
 	.set_group_hold = imx304_set_group_hold,
+	.set_gain_ex = imx304_set_gain_ex,
+	.set_exposure_ex = imx304_set_exposure_ex,
+	.set_frame_rate_ex = imx304_set_frame_rate_ex,
+	.set_group_hold_ex = imx304_set_group_hold_ex,
 	.set_test_pattern = imx304_set_test_pattern,
 	.set_operation_mode = imx304_set_operation_mode,
 	.set_shutter_mode = imx304_set_shutter_mode,
@@ -1559,7 +1551,8 @@ static int imx304_probe(struct i2c_client *client, const struct i2c_device_id *i
 	tc_dev->dev_regmap_config = &sensor_regmap_config;
 	tc_dev->sensor_ops = &imx304_common_ops;
 	tc_dev->v4l2sd_internal_ops = &imx304_subdev_internal_ops;
-	tc_dev->tcctrl_ops = &imx304_ctrl_ops;
+	fr_select_ctrl_ops(&priv->ctrl_ops, &imx304_ctrl_ops);
+	tc_dev->tcctrl_ops = &priv->ctrl_ops;
 
 	err = tegracam_device_register(tc_dev);
 	if (err) {
@@ -1571,6 +1564,13 @@ static int imx304_probe(struct i2c_client *client, const struct i2c_device_id *i
 	priv->subdev = &tc_dev->s_data->subdev;
 	tegracam_set_privdata(tc_dev, (void *)priv);
 
+	err = fr_table_cache_add(dev, &priv->table_cache, mode_table,
+			ARRAY_SIZE(mode_table), IMX304_TABLE_WAIT_MS, IMX304_TABLE_END);
+	if (err) {
+		dev_err(dev, "unable to compile mode tables\n");
+		return err;
+	}
+
 	priv->frame_length = IMX304_DEFAULT_HEIGHT
 					+ IMX304_MIN_FRAME_LENGTH_DELTA;
 	priv->line_time = IMX304_DEFAULT_LINE_TIME;
@@ -1626,6 +1626,8 @@ static int imx304_probe(struct i2c_client *client, const struct i2c_device_id *i
 	if (err)
 		return err;
 
+	fr_stop_debugfs_init(dev, &priv->stream_stop);
+
 	dev_info(dev, "Detected imx304 sensor\n");
 
 	return 0;
@@ -1654,12 +1656,10 @@ static void imx304_remove(struct i2c_client *client)
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
 		imx304_gmsl_serdes_reset(priv);
 
+	fr_stop_debugfs_remove(&priv->stream_stop);
 	tegracam_v4l2subdev_unregister(priv->tc_dev);
 	tegracam_device_unregister(priv->tc_dev);
 
-	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
-		mutex_destroy(&serdes_lock__);
-
 #if defined(NV_I2C_DRIVER_STRUCT_REMOVE_RETURN_TYPE_INT) /* Linux 6.1 */
 	return 0;
 #endif
@@ -1676,6 +1676,7 @@ static struct i2c_driver imx304_i2c_driver = {
 		.name = "imx304",
 		.owner = THIS_MODULE,
 		.of_match_table = of_match_ptr(imx304_of_match),
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 	},
 	.probe = imx304_probe,
 	.remove = imx304_remove,
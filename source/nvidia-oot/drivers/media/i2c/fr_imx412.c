@@ -58,8 +58,7 @@
 #define IMX412_INCK				27000000LL
 
 LIST_HEAD(imx412_sensor_list);
-
-static struct mutex serdes_lock__;
+static DEFINE_MUTEX(imx412_sensor_list_lock);
 
 static const struct of_device_id imx412_of_match[] = {
 	{
@@ -101,14 +100,17 @@ struct imx412 {
 	struct list_head entry;
 	struct camera_common_data *s_data;
 	struct tegracam_device *tc_dev;
+	struct fr_table_stats table_stats;
+	struct fr_table_cache table_cache;
+	struct fr_stop_ctx stream_stop;
+	struct fr_ctrl_blob ctrl_blob;
+	struct tegracam_ctrl_ops ctrl_ops;
 };
 
 static const struct regmap_config sensor_regmap_config = {
 	.reg_bits = 16,
 	.val_bits = 8,
 	.cache_type = REGCACHE_RBTREE,
-	.use_single_read = true,
-	.use_single_write = true,
 };
 
 static inline int imx412_read_reg(struct camera_common_data *s_data, u16 addr,
@@ -156,122 +158,39 @@ static int imx412_read_buffered_reg(struct camera_common_data *s_data,
 					u16 addr_low, u8 number_of_registers,
 					u64 *val)
 {
-	struct device *dev = s_data->dev;
-	int err, i;
-	u8 reg;
-
-	*val = 0;
-
-	if (!s_data->group_hold_active) {
-		err = imx412_write_reg(s_data, GRP_PARAM_HOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: error setting register hold\n",
-				__func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx412_read_reg(s_data, addr_low - i, &reg);
-		*val += reg << (i * 8);
-		if (err) {
-			dev_err(dev, "%s: error reading buffered registers\n",
-				__func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx412_write_reg(s_data, GRP_PARAM_HOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: error unsetting register hold\n",
-				__func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_read_buffered_reg(s_data, s_data->regmap, GRP_PARAM_HOLD,
+			addr_low, number_of_registers, val, true);
 }
 
 static int imx412_write_buffered_reg(struct camera_common_data *s_data,
 					 u16 addr_low, u8 number_of_registers,
 					 u64 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx412_write_reg(s_data, GRP_PARAM_HOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx412_write_reg(s_data, addr_low - i,
-					(u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n",
-				__func__);
-			return err;
-		}
-	}
+	struct imx412 *priv = (struct imx412 *)s_data->priv;
 
-	if (!s_data->group_hold_active) {
-		err = imx412_write_reg(s_data, GRP_PARAM_HOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-			return err;
-		}
-	}
+	if (priv->ctrl_blob.blob)
+		return fr_blob_buffered_reg(&priv->ctrl_blob, GRP_PARAM_HOLD,
+			addr_low, number_of_registers, val, true);
 
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->regmap, GRP_PARAM_HOLD,
+			addr_low, number_of_registers, val, true);
 }
 
 static int imx412_broadcast_buffered_reg(struct camera_common_data *s_data,
 					 u16 addr_low, u8 number_of_registers,
 					 u32 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx412_write_reg_broadcast(s_data, GRP_PARAM_HOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx412_write_reg_broadcast(s_data, addr_low - i,
-						 (u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n",
-				__func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx412_write_reg_broadcast(s_data, GRP_PARAM_HOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->broadcast_regmap, GRP_PARAM_HOLD,
+			addr_low, number_of_registers, val, true);
 }
 
 static int imx412_write_table(struct imx412 *priv, const imx412_reg table[])
 {
 	struct camera_common_data *s_data = priv->s_data;
 
-	return regmap_util_write_table_8(s_data->regmap, table, NULL, 0,
-					 IMX412_TABLE_WAIT_MS,
-					 IMX412_TABLE_END);
+	return fr_write_table_cached(s_data->regmap, &priv->table_cache,
+				table, IMX412_TABLE_WAIT_MS, IMX412_TABLE_END,
+				&priv->table_stats);
 }
 
 static int imx412_set_group_hold(struct tegracam_device *tc_dev, bool val)
@@ -654,6 +573,7 @@ static bool imx412_find_broadcast_sensor(struct imx412 *broadcast_private)
 {
 	struct imx412 *current_private;
 
+	mutex_lock(&imx412_sensor_list_lock);
 	list_for_each_entry(current_private, &imx412_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		if (current_private->broadcast_ctrl == BROADCAST &&
@@ -661,10 +581,12 @@ static bool imx412_find_broadcast_sensor(struct imx412 *broadcast_private)
 			mutex_unlock(&current_private->pw_mutex);
 			memcpy(broadcast_private, current_private,
 				sizeof(*broadcast_private));
+			mutex_unlock(&imx412_sensor_list_lock);
 			return true;
 		}
 		mutex_unlock(&current_private->pw_mutex);
 	}
+	mutex_unlock(&imx412_sensor_list_lock);
 	return false;
 }
 
@@ -673,6 +595,7 @@ static void imx412_enable_second_slave_address(struct imx412 *ack_private)
 	struct imx412 *current_private;
 	int err;
 
+	mutex_lock(&imx412_sensor_list_lock);
 	list_for_each_entry(current_private, &imx412_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		if (current_private->s_data->power->state != SWITCH_ON) {
@@ -694,6 +617,7 @@ static void imx412_enable_second_slave_address(struct imx412 *ack_private)
 		dev_dbg(&current_private->i2c_client->dev,
 			"%s: Sensors 2nd slave address configured\n", __func__);
 	}
+	mutex_unlock(&imx412_sensor_list_lock);
 
 	err = imx412_write_reg(ack_private->s_data, SLAVE_ADD_ACKEN_2ND, 1);
 	if (err)
@@ -709,6 +633,7 @@ static void imx412_disable_second_slave_address(void)
 	struct imx412 *current_private;
 	int err;
 
+	mutex_lock(&imx412_sensor_list_lock);
 	list_for_each_entry(current_private, &imx412_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		if (current_private->s_data->power->state != SWITCH_ON) {
@@ -728,6 +653,7 @@ static void imx412_disable_second_slave_address(void)
 		dev_dbg(&current_private->i2c_client->dev,
 			"%s: Sensors 2nd slave address disabled\n", __func__);
 	}
+	mutex_unlock(&imx412_sensor_list_lock);
 }
 
 static void imx412_configure_second_slave_address(void)
@@ -863,6 +789,7 @@ static int imx412_power_off(struct camera_common_data *s_data)
 	}
 
 power_off_done:
+	fr_table_cache_invalidate(s_data->regmap, &priv->table_cache);
 	pw->state = SWITCH_OFF;
 	mutex_unlock(&priv->pw_mutex);
 
@@ -1288,8 +1215,14 @@ static int imx412_set_mode(struct tegracam_device *tc_dev)
 	struct imx412 *priv = (struct imx412 *)tegracam_get_privdata(tc_dev);
 	struct camera_common_data *s_data = tc_dev->s_data;
 	struct device *dev = tc_dev->dev;
+	struct fr_ctrl_snapshot ctrls;
 	int err;
 
+	fr_table_stats_begin(&priv->table_stats);
+	fr_stream_settle(&priv->stream_stop);
+	fr_table_cache_begin_mode(&priv->table_cache);
+	fr_ctrl_snapshot_take(tc_dev, &ctrls);
+
 	err = imx412_write_table(priv, mode_table[IMX412_GLOBAL_SETTINGS]);
 	if (err) {
 		dev_err(dev, "%s: unable to set global settings\n", __func__);
@@ -1346,9 +1279,7 @@ static int imx412_set_mode(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
-	err = imx412_set_operation_mode(
-		tc_dev, fr_get_v4l2_ctrl_value(
-			tc_dev, TEGRA_CAMERA_CID_OPERATION_MODE, CURRENT));
+	err = imx412_set_operation_mode(tc_dev, ctrls.operation_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to set operation mode\n", __func__);
 		return err;
@@ -1360,9 +1291,7 @@ static int imx412_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx412_set_test_pattern(
-		tc_dev, fr_get_v4l2_ctrl_value(
-			tc_dev, TEGRA_CAMERA_CID_TEST_PATTERN, CURRENT));
+	err = imx412_set_test_pattern(tc_dev, ctrls.test_pattern);
 	if (err) {
 		dev_err(dev, "%s: unable to set Test pattern\n", __func__);
 		return err;
@@ -1384,6 +1313,8 @@ static int imx412_set_mode(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
+	fr_table_cache_end_mode(&priv->table_cache);
+	fr_table_stats_end(dev, &priv->table_stats, s_data->mode);
 	dev_dbg(dev, "%s: set mode %u\n", __func__, s_data->mode);
 
 	return 0;
@@ -1426,6 +1357,8 @@ static int imx412_stop_streaming(struct tegracam_device *tc_dev)
 	struct device *dev = tc_dev->dev;
 	int err;
 
+	fr_stream_stop_begin(&priv->stream_stop);
+
 	if (!strcmp(s_data->pdata->gmsl, "gmsl"))
 		max96792_stop_streaming(priv->s_data->dser_dev, dev);
 
@@ -1433,8 +1366,8 @@ static int imx412_stop_streaming(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
-	usleep_range(priv->frame_length * priv->line_time / IMX412_K_FACTOR,
-		priv->frame_length * priv->line_time / IMX412_K_FACTOR + 1000);
+	fr_stream_stop_end(&priv->stream_stop,
+		priv->frame_length * priv->line_time / IMX412_K_FACTOR);
 
 	return 0;
 }
@@ -1470,7 +1403,7 @@ static int imx412_gmsl_serdes_setup(struct imx412 *priv)
 
 	dev_dbg(dev, "%s: function entered\n", __func__);
 
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
@@ -1517,20 +1450,20 @@ static int imx412_gmsl_serdes_setup(struct imx412 *priv)
 	}
 
 error:
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 	return err;
 }
 
 static void imx412_gmsl_serdes_reset(struct imx412 *priv)
 {
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96793_reset_control(priv->s_data->ser_dev);
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
 	max96792_power_off(priv->s_data->dser_dev, &priv->s_data->g_ctx);
 
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 }
 
 static int imx412_board_setup(struct imx412 *priv)
@@ -1710,7 +1643,6 @@ static int imx412_board_setup(struct imx412 *priv)
 
 		priv->s_data->g_ctx.s_dev = dev;
 
-		mutex_init(&serdes_lock__);
 		err = max96793_sdev_pair(priv->s_data->ser_dev,
 					 &priv->s_data->g_ctx);
 		if (err) {
@@ -1779,13 +1711,52 @@ static const struct v4l2_subdev_internal_ops imx412_subdev_internal_ops = {
 	.open = imx412_open,
 };
 
-static struct tegracam_ctrl_ops imx412_ctrl_ops = {
+static int imx412_set_group_hold_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, bool val)
+{
+	struct imx412 *priv = (struct imx412 *)tc_dev->priv;
+
+	return fr_set_group_hold_ex(&priv->ctrl_blob, blob, GRP_PARAM_HOLD, val);
+}
+
+static int imx412_set_gain_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx412 *priv = (struct imx412 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx412_set_gain, val);
+}
+
+static int imx412_set_exposure_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx412 *priv = (struct imx412 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx412_set_exposure, val);
+}
+
+static int imx412_set_frame_rate_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx412 *priv = (struct imx412 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx412_set_frame_rate, val);
+}
+
+static const struct tegracam_ctrl_ops imx412_ctrl_ops = {
 	.numctrls = ARRAY_SIZE(ctrl_cid_list),
 	.ctrl_cid_list = ctrl_cid_list,
 	.set_gain = imx412_set_gain,
 	.set_exposure = imx412_set_exposure,
 	.set_frame_rate = imx412_set_frame_rate,
 	.set_group_hold = imx412_set_group_hold,
+	.set_gain_ex = imx412_set_gain_ex,
+	.set_exposure_ex = imx412_set_exposure_ex,
+	.set_frame_rate_ex = imx412_set_frame_rate_ex,
+	.set_group_hold_ex = imx412_set_group_hold_ex,
 	.set_test_pattern = imx412_set_test_pattern,
 	.set_operation_mode = imx412_set_operation_mode,
 	.set_broadcast_ctrl = imx412_set_broadcast_ctrl,
@@ -1825,7 +1796,8 @@ static int imx412_probe(struct i2c_client *client,
 	tc_dev->dev_regmap_config = &sensor_regmap_config;
 	tc_dev->sensor_ops = &imx412_common_ops;
 	tc_dev->v4l2sd_internal_ops = &imx412_subdev_internal_ops;
-	tc_dev->tcctrl_ops = &imx412_ctrl_ops;
+	fr_select_ctrl_ops(&priv->ctrl_ops, &imx412_ctrl_ops);
+	tc_dev->tcctrl_ops = &priv->ctrl_ops;
 
 	err = tegracam_device_register(tc_dev);
 	if (err) {
@@ -1837,6 +1809,13 @@ static int imx412_probe(struct i2c_client *client,
 	priv->subdev = &tc_dev->s_data->subdev;
 	tegracam_set_privdata(tc_dev, (void *)priv);
 
+	err = fr_table_cache_add(dev, &priv->table_cache, mode_table,
+			ARRAY_SIZE(mode_table), IMX412_TABLE_WAIT_MS, IMX412_TABLE_END);
+	if (err) {
+		dev_err(dev, "unable to compile mode tables\n");
+		return err;
+	}
+
 	priv->broadcast_ctrl = UNICAST;
 	priv->s_data->broadcast_regmap = NULL;
 	priv->current_pixel_format = MEDIA_BUS_FMT_SRGGB10_1X10;
@@ -1873,7 +1852,11 @@ static int imx412_probe(struct i2c_client *client,
 	if (err)
 		return err;
 
+	mutex_lock(&imx412_sensor_list_lock);
 	list_add_tail(&priv->entry, &imx412_sensor_list);
+	mutex_unlock(&imx412_sensor_list_lock);
+
+	fr_stop_debugfs_init(dev, &priv->stream_stop);
 
 	dev_info(dev, "Detected imx412 sensor\n");
 
@@ -1903,12 +1886,10 @@ static void imx412_remove(struct i2c_client *client)
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
 		imx412_gmsl_serdes_reset(priv);
 
+	fr_stop_debugfs_remove(&priv->stream_stop);
 	tegracam_v4l2subdev_unregister(priv->tc_dev);
 	tegracam_device_unregister(priv->tc_dev);
 
-	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
-		mutex_destroy(&serdes_lock__);
-
 #if defined(NV_I2C_DRIVER_STRUCT_REMOVE_RETURN_TYPE_INT) /* Linux 6.1 */
 	return 0;
 #endif
@@ -1923,6 +1904,7 @@ static struct i2c_driver imx412_i2c_driver = {
 		.name = "imx412",
 		.owner = THIS_MODULE,
 		.of_match_table = of_match_ptr(imx412_of_match),
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 	},
 	.probe = imx412_probe,
 	.remove = imx412_remove,
@@ -56,8 +56,7 @@
 #define IMX464_DOL2_MIN_INTEGRATION_LINES	2
 
 LIST_HEAD(imx464_sensor_list);
-
-static struct mutex serdes_lock__;
+static DEFINE_MUTEX(imx464_sensor_list_lock);
 
 static const struct of_device_id imx464_of_match[] = {
 	{
@@ -119,14 +118,17 @@ struct imx464 {
 	struct list_head entry;
 	struct camera_common_data *s_data;
 	struct tegracam_device *tc_dev;
+	struct fr_table_stats table_stats;
+	struct fr_table_cache table_cache;
+	struct fr_stop_ctx stream_stop;
+	struct fr_ctrl_blob ctrl_blob;
+	struct tegracam_ctrl_ops ctrl_ops;
 };
 
 static const struct regmap_config sensor_regmap_config = {
 	.reg_bits = 16,
 	.val_bits = 8,
 	.cache_type = REGCACHE_RBTREE,
-	.use_single_read = true,
-	.use_single_write = true,
 };
 
 static inline int imx464_read_reg(struct camera_common_data *s_data, u16 addr,
@@ -154,141 +156,43 @@ static int imx464_write_reg(struct camera_common_data *s_data, u16 addr, u8 val)
 	return err;
 }
 
-static int imx464_write_reg_broadcast(struct camera_common_data *s_data,
-					u16 addr, u8 val)
-{
-	int err;
-	struct device *dev = s_data->dev;
-
-	err = regmap_write(s_data->broadcast_regmap, addr, val);
-	if (err) {
-		dev_err(dev, "%s: i2c write failed, %x = %x\n", __func__, addr,
-			val);
-	}
-
-	return err;
-}
-
 static int imx464_read_buffered_reg(struct camera_common_data *s_data,
 					u16 addr_low, u8 number_of_registers,
 					u64 *val)
 {
-	struct device *dev = s_data->dev;
-	int err, i;
-	u8 reg;
-
-	*val = 0;
-
-	if (!s_data->group_hold_active) {
-		err = imx464_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: error setting register hold\n",
-				__func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx464_read_reg(s_data, addr_low + i, &reg);
-		*val += reg << (i * 8);
-		if (err) {
-			dev_err(dev, "%s: error reading buffered registers\n",
-				__func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx464_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: error unsetting register hold\n",
-				__func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_read_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx464_write_buffered_reg(struct camera_common_data *s_data,
 					 u16 addr_low, u8 number_of_registers,
 					 u64 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx464_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx464_write_reg(s_data, addr_low + i,
-					(u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n",
-				__func__);
-			return err;
-		}
-	}
+	struct imx464 *priv = (struct imx464 *)s_data->priv;
 
-	if (!s_data->group_hold_active) {
-		err = imx464_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-			return err;
-		}
-	}
+	if (priv->ctrl_blob.blob)
+		return fr_blob_buffered_reg(&priv->ctrl_blob, REGHOLD,
+			addr_low, number_of_registers, val, false);
 
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx464_broadcast_buffered_reg(struct camera_common_data *s_data,
 					 u16 addr_low, u8 number_of_registers,
 					 u32 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx464_write_reg_broadcast(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx464_write_reg_broadcast(s_data, addr_low + i,
-						 (u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n",
-				__func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx464_write_reg_broadcast(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->broadcast_regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx464_write_table(struct imx464 *priv, const imx464_reg table[])
 {
 	struct camera_common_data *s_data = priv->s_data;
 
-	return regmap_util_write_table_8(s_data->regmap, table, NULL, 0,
-					 IMX464_TABLE_WAIT_MS,
-					 IMX464_TABLE_END);
+	return fr_write_table_cached(s_data->regmap, &priv->table_cache,
+				table, IMX464_TABLE_WAIT_MS, IMX464_TABLE_END,
+				&priv->table_stats);
 }
 
 static int imx464_set_group_hold(struct tegracam_device *tc_dev, bool val)
@@ -700,6 +604,7 @@ static bool imx464_find_broadcast_sensor(struct imx464 *broadcast_private)
 {
 	struct imx464 *current_private;
 
+	mutex_lock(&imx464_sensor_list_lock);
 	list_for_each_entry(current_private, &imx464_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		if (current_private->broadcast_ctrl == BROADCAST &&
@@ -707,10 +612,12 @@ static bool imx464_find_broadcast_sensor(struct imx464 *broadcast_private)
 			mutex_unlock(&current_private->pw_mutex);
 			memcpy(broadcast_private, current_private,
 				sizeof(*broadcast_private));
+			mutex_unlock(&imx464_sensor_list_lock);
 			return true;
 		}
 		mutex_unlock(&current_private->pw_mutex);
 	}
+	mutex_unlock(&imx464_sensor_list_lock);
 	return false;
 }
 
@@ -719,6 +626,7 @@ static void imx464_enable_second_slave_address(struct imx464 *ack_private)
 	struct imx464 *current_private;
 	int err;
 
+	mutex_lock(&imx464_sensor_list_lock);
 	list_for_each_entry(current_private, &imx464_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		if (current_private->s_data->power->state != SWITCH_ON) {
@@ -738,6 +646,7 @@ static void imx464_enable_second_slave_address(struct imx464 *ack_private)
 		dev_dbg(&current_private->i2c_client->dev,
 			"%s: Sensors 2nd slave address configured\n", __func__);
 	}
+	mutex_unlock(&imx464_sensor_list_lock);
 
 	err = imx464_write_reg(ack_private->s_data, SECOND_SLAVE_ADD, 7);
 	if (err)
@@ -753,6 +662,7 @@ static void imx464_disable_second_slave_address(void)
 	struct imx464 *current_private;
 	int err;
 
+	mutex_lock(&imx464_sensor_list_lock);
 	list_for_each_entry(current_private, &imx464_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		if (current_private->s_data->power->state != SWITCH_ON) {
@@ -772,6 +682,7 @@ static void imx464_disable_second_slave_address(void)
 		dev_dbg(&current_private->i2c_client->dev,
 			"%s: Sensors 2nd slave address disabled\n", __func__);
 	}
+	mutex_unlock(&imx464_sensor_list_lock);
 }
 
 static void imx464_configure_second_slave_address(void)
@@ -909,6 +820,7 @@ static int imx464_power_off(struct camera_common_data *s_data)
 	}
 
 power_off_done:
+	fr_table_cache_invalidate(s_data->regmap, &priv->table_cache);
 	pw->state = SWITCH_OFF;
 	mutex_unlock(&priv->pw_mutex);
 
@@ -1363,8 +1275,14 @@ static int imx464_set_mode(struct tegracam_device *tc_dev)
 	struct imx464 *priv = (struct imx464 *)tegracam_get_privdata(tc_dev);
 	struct camera_common_data *s_data = tc_dev->s_data;
 	struct device *dev = tc_dev->dev;
+	struct fr_ctrl_snapshot ctrls;
 	int err;
 
+	fr_table_stats_begin(&priv->table_stats);
+	fr_stream_settle(&priv->stream_stop);
+	fr_table_cache_begin_mode(&priv->table_cache);
+	fr_ctrl_snapshot_take(tc_dev, &ctrls);
+
 	err = imx464_write_table(priv, mode_table[IMX464_INIT_SETTINGS]);
 	if (err) {
 		dev_err(dev, "%s: unable to initialize sensor settings\n",
@@ -1389,17 +1307,13 @@ static int imx464_set_mode(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
-	err = imx464_set_operation_mode(
-		tc_dev, fr_get_v4l2_ctrl_value(
-			tc_dev, TEGRA_CAMERA_CID_OPERATION_MODE, CURRENT));
+	err = imx464_set_operation_mode(tc_dev, ctrls.operation_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to operation mode\n", __func__);
 		return err;
 	}
 
-	err = imx464_set_sync_mode(
-		tc_dev, fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_SYNC_MODE,
-					CURRENT));
+	err = imx464_set_sync_mode(tc_dev, ctrls.sync_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to set sync mode\n", __func__);
 		return err;
@@ -1419,9 +1333,7 @@ static int imx464_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx464_set_test_pattern(
-		tc_dev, fr_get_v4l2_ctrl_value(
-			tc_dev, TEGRA_CAMERA_CID_TEST_PATTERN, CURRENT));
+	err = imx464_set_test_pattern(tc_dev, ctrls.test_pattern);
 	if (err) {
 		dev_err(dev, "%s: unable to set Test pattern\n", __func__);
 		return err;
@@ -1443,6 +1355,8 @@ static int imx464_set_mode(struct tegracam_device *tc_dev)
 	if (err)
 		goto fail;
 
+	fr_table_cache_end_mode(&priv->table_cache);
+	fr_table_stats_end(dev, &priv->table_stats, s_data->mode);
 	dev_dbg(dev, "%s: set mode %u\n", __func__, s_data->mode);
 
 	return 0;
@@ -1503,6 +1417,8 @@ static int imx464_stop_streaming(struct tegracam_device *tc_dev)
 	struct device *dev = tc_dev->dev;
 	int err;
 
+	fr_stream_stop_begin(&priv->stream_stop);
+
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
 		max96792_stop_streaming(priv->s_data->dser_dev, dev);
 
@@ -1510,9 +1426,8 @@ static int imx464_stop_streaming(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
-	usleep_range(priv->frame_length * priv->line_time / IMX464_K_FACTOR,
-			 priv->frame_length * priv->line_time / IMX464_K_FACTOR +
-			 1000);
+	fr_stream_stop_end(&priv->stream_stop,
+		priv->frame_length * priv->line_time / IMX464_K_FACTOR);
 
 	return 0;
 }
@@ -1548,7 +1463,7 @@ static int imx464_gmsl_serdes_setup(struct imx464 *priv)
 
 	dev_dbg(dev, "%s: Enter function\n", __func__);
 
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
@@ -1596,20 +1511,20 @@ static int imx464_gmsl_serdes_setup(struct imx464 *priv)
 	}
 
 error:
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 	return err;
 }
 
 static void imx464_gmsl_serdes_reset(struct imx464 *priv)
 {
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96793_reset_control(priv->s_data->ser_dev);
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
 	max96792_power_off(priv->s_data->dser_dev, &priv->s_data->g_ctx);
 
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 }
 
 static int imx464_board_setup(struct imx464 *priv)
@@ -1791,7 +1706,6 @@ static int imx464_board_setup(struct imx464 *priv)
 
 		priv->s_data->g_ctx.s_dev = dev;
 
-		mutex_init(&serdes_lock__);
 		err = max96793_sdev_pair(priv->s_data->ser_dev,
 					 &priv->s_data->g_ctx);
 		if (err) {
@@ -1861,7 +1775,42 @@ static const struct v4l2_subdev_internal_ops imx464_subdev_internal_ops = {
 	.open = imx464_open,
 };
 
-static struct tegracam_ctrl_ops imx464_ctrl_ops = {
+static int imx464_set_group_hold_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, bool val)
+{
+	struct imx464 *priv = (struct imx464 *)tc_dev->priv;
+
+	return fr_set_group_hold_ex(&priv->ctrl_blob, blob, REGHOLD, val);
+}
+
+static int imx464_set_gain_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx464 *priv = (struct imx464 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx464_set_gain, val);
+}
+
+static int imx464_set_exposure_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx464 *priv = (struct imx464 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx464_set_exposure, val);
+}
+
+static int imx464_set_frame_rate_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx464 *priv = (struct imx464 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx464_set_frame_rate, val);
+}
+
+static const struct tegracam_ctrl_ops imx464_ctrl_ops = {
 	.numctrls = ARRAY_SIZE(ctrl_cid_list),
 	.ctrl_cid_list = ctrl_cid_list,
 	.set_gain = imx464_set_gain,
@@ -1869,6 +1818,10 @@ static struct tegracam_ctrl_ops imx464_ctrl_ops = {
 	.set_exposure_short = imx464_set_exposure_shr_dol_short,
 	.set_frame_rate = imx464_set_frame_rate,
 	.set_group_hold = imx464_set_group_hold,
+	.set_gain_ex = imx464_set_gain_ex,
+	.set_exposure_ex = imx464_set_exposure_ex,
+	.set_frame_rate_ex = imx464_set_frame_rate_ex,
+	.set_group_hold_ex = imx464_set_group_hold_ex,
 	.set_test_pattern = imx464_set_test_pattern,
 	.set_data_rate = imx464_set_data_rate,
 	.set_operation_mode = imx464_set_operation_mode,
@@ -1910,7 +1863,8 @@ static int imx464_probe(struct i2c_client *client,
 	tc_dev->dev_regmap_config = &sensor_regmap_config;
 	tc_dev->sensor_ops = &imx464_common_ops;
 	tc_dev->v4l2sd_internal_ops = &imx464_subdev_internal_ops;
-	tc_dev->tcctrl_ops = &imx464_ctrl_ops;
+	fr_select_ctrl_ops(&priv->ctrl_ops, &imx464_ctrl_ops);
+	tc_dev->tcctrl_ops = &priv->ctrl_ops;
 
 	err = tegracam_device_register(tc_dev);
 	if (err) {
@@ -1923,6 +1877,17 @@ static int imx464_probe(struct i2c_client *client,
 	priv->subdev = &tc_dev->s_data->subdev;
 	tegracam_set_privdata(tc_dev, (void *)priv);
 
+	err = fr_table_cache_add(dev, &priv->table_cache, mode_table,
+			ARRAY_SIZE(mode_table), IMX464_TABLE_WAIT_MS, IMX464_TABLE_END);
+	if (!err)
+		err = fr_table_cache_add(dev, &priv->table_cache,
+			data_rate_table, ARRAY_SIZE(data_rate_table),
+			IMX464_TABLE_WAIT_MS, IMX464_TABLE_END);
+	if (err) {
+		dev_err(dev, "unable to compile mode tables\n");
+		return err;
+	}
+
 	priv->broadcast_ctrl = UNICAST;
 	priv->s_data->broadcast_regmap = NULL;
 	priv->brl = IMX464_DOL2_BRL_FULL_FRAME_MODE;
@@ -1966,7 +1931,11 @@ static int imx464_probe(struct i2c_client *client,
 	if (err)
 		return err;
 
+	mutex_lock(&imx464_sensor_list_lock);
 	list_add_tail(&priv->entry, &imx464_sensor_list);
+	mutex_unlock(&imx464_sensor_list_lock);
+
+	fr_stop_debugfs_init(dev, &priv->stream_stop);
 
 	dev_info(dev, "Detected imx464 sensor\n");
 
@@ -1996,12 +1965,10 @@ static void imx464_remove(struct i2c_client *client)
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
 		imx464_gmsl_serdes_reset(priv);
 
+	fr_stop_debugfs_remove(&priv->stream_stop);
 	tegracam_v4l2subdev_unregister(priv->tc_dev);
 	tegracam_device_unregister(priv->tc_dev);
 
-	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
-		mutex_destroy(&serdes_lock__);
-
 #if defined(NV_I2C_DRIVER_STRUCT_REMOVE_RETURN_TYPE_INT) /* Linux 6.1 */
 	return 0;
 #endif
@@ -2016,6 +1983,7 @@ static struct i2c_driver imx464_i2c_driver = {
 		.name = "imx464",
 		.owner = THIS_MODULE,
 		.of_match_table = of_match_ptr(imx464_of_match),
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 	},
 	.probe = imx464_probe,
 	.remove = imx464_remove,
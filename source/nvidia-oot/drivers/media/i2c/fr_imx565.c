@@ -53,8 +53,7 @@
 #define IMX565_TWO_LANE_MODE				2
 
 LIST_HEAD(imx565_sensor_list);
-
-static struct mutex serdes_lock__;
+static DEFINE_MUTEX(imx565_sensor_list_lock);
 
 static const struct of_device_id imx565_of_match[] = {
 	{
@@ -100,14 +99,17 @@ struct imx565 {
 	struct mutex pw_mutex;
 	struct camera_common_data *s_data;
 	struct tegracam_device *tc_dev;
+	struct fr_table_stats table_stats;
+	struct fr_table_cache table_cache;
+	struct fr_stop_ctx stream_stop;
+	struct fr_ctrl_blob ctrl_blob;
+	struct tegracam_ctrl_ops ctrl_ops;
 };
 
 static const struct regmap_config sensor_regmap_config = {
 	.reg_bits = 16,
 	.val_bits = 8,
 	.cache_type = REGCACHE_RBTREE,
-	.use_single_read = true,
-	.use_single_write = true,
 };
 
 static inline int imx565_read_reg(struct camera_common_data *s_data, u16 addr,
@@ -139,86 +141,31 @@ static int imx565_read_buffered_reg(struct camera_common_data *s_data,
 					u16 addr_low, u8 number_of_registers,
 					u64 *val)
 {
-	struct device *dev = s_data->dev;
-	int err, i;
-	u8 reg;
-
-	*val = 0;
-
-	if (!s_data->group_hold_active) {
-		err = imx565_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: error setting register hold\n",
-				__func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx565_read_reg(s_data, addr_low + i, &reg);
-		*val += reg << (i * 8);
-		if (err) {
-			dev_err(dev, "%s: error reading buffered registers\n",
-				__func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx565_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: error unsetting register hold\n",
-				__func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_read_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx565_write_buffered_reg(struct camera_common_data *s_data,
 					 u16 addr_low, u8 number_of_registers,
 					 u64 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx565_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx565_write_reg(s_data, addr_low + i,
-					 (u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n",
-				__func__);
-			return err;
-		}
-	}
+	struct imx565 *priv = (struct imx565 *)s_data->priv;
 
-	if (!s_data->group_hold_active) {
-		err = imx565_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-			return err;
-		}
-	}
+	if (priv->ctrl_blob.blob)
+		return fr_blob_buffered_reg(&priv->ctrl_blob, REGHOLD,
+			addr_low, number_of_registers, val, false);
 
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx565_write_table(struct imx565 *priv, const imx565_reg table[])
 {
 	struct camera_common_data *s_data = priv->s_data;
 
-	return regmap_util_write_table_8(s_data->regmap, table, NULL, 0,
-					 IMX565_TABLE_WAIT_MS,
-					 IMX565_TABLE_END);
+	return fr_write_table_cached(s_data->regmap, &priv->table_cache,
+				table, IMX565_TABLE_WAIT_MS, IMX565_TABLE_END,
+				&priv->table_stats);
 }
 
 static int imx565_set_group_hold(struct tegracam_device *tc_dev, bool val)
@@ -608,6 +555,7 @@ static int imx565_power_off(struct camera_common_data *s_data)
 	}
 
 power_off_done:
+	fr_table_cache_invalidate(s_data->regmap, &priv->table_cache);
 	pw->state = SWITCH_OFF;
 	mutex_unlock(&priv->pw_mutex);
 
@@ -1384,8 +1332,14 @@ static int imx565_set_mode(struct tegracam_device *tc_dev)
 	struct imx565 *priv = (struct imx565 *)tegracam_get_privdata(tc_dev);
 	struct camera_common_data *s_data = tc_dev->s_data;
 	struct device *dev = tc_dev->dev;
+	struct fr_ctrl_snapshot ctrls;
 	int err;
 
+	fr_table_stats_begin(&priv->table_stats);
+	fr_stream_settle(&priv->stream_stop);
+	fr_table_cache_begin_mode(&priv->table_cache);
+	fr_ctrl_snapshot_take(tc_dev, &ctrls);
+
 	err = imx565_write_table(priv, mode_table[IMX565_INIT_SETTINGS]);
 	if (err) {
 		dev_err(dev, "%s: unable to initialize sensor settings\n",
@@ -1413,9 +1367,7 @@ static int imx565_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx565_set_operation_mode(
-		tc_dev, fr_get_v4l2_ctrl_value(
-			tc_dev, TEGRA_CAMERA_CID_OPERATION_MODE, CURRENT));
+	err = imx565_set_operation_mode(tc_dev, ctrls.operation_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to set operation mode\n", __func__);
 		return err;
@@ -1443,9 +1395,7 @@ static int imx565_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx565_set_test_pattern(
-		tc_dev, fr_get_v4l2_ctrl_value(
-			tc_dev, TEGRA_CAMERA_CID_TEST_PATTERN, CURRENT));
+	err = imx565_set_test_pattern(tc_dev, ctrls.test_pattern);
 	if (err) {
 		dev_err(dev, "%s: unable to set Test pattern\n", __func__);
 		return err;
@@ -1471,6 +1421,8 @@ static int imx565_set_mode(struct tegracam_device *tc_dev)
 	if (err)
 		goto fail;
 
+	fr_table_cache_end_mode(&priv->table_cache);
+	fr_table_stats_end(dev, &priv->table_stats, s_data->mode);
 	dev_dbg(dev, "%s: set mode %u\n", __func__, s_data->mode);
 
 	return 0;
@@ -1529,6 +1481,8 @@ static int imx565_stop_streaming(struct tegracam_device *tc_dev)
 	struct device *dev = tc_dev->dev;
 	int err;
 
+	fr_stream_stop_begin(&priv->stream_stop);
+
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
 		max96792_stop_streaming(priv->s_data->dser_dev, dev);
 
@@ -1536,8 +1490,8 @@ static int imx565_stop_streaming(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
-	usleep_range(priv->frame_length * priv->line_time / IMX565_K_FACTOR,
-		priv->frame_length * priv->line_time / IMX565_K_FACTOR + 1000);
+	fr_stream_stop_end(&priv->stream_stop,
+		priv->frame_length * priv->line_time / IMX565_K_FACTOR);
 
 	return 0;
 }
@@ -1570,7 +1524,7 @@ static int imx565_gmsl_serdes_setup(struct imx565 *priv)
 
 	dev = &priv->i2c_client->dev;
 
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
@@ -1618,20 +1572,20 @@ static int imx565_gmsl_serdes_setup(struct imx565 *priv)
 	}
 
 error:
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 	return err;
 }
 
 static void imx565_gmsl_serdes_reset(struct imx565 *priv)
 {
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96793_reset_control(priv->s_data->ser_dev);
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
 	max96792_power_off(priv->s_data->dser_dev, &priv->s_data->g_ctx);
 
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 }
 
 static int imx565_board_setup(struct imx565 *priv)
@@ -1813,7 +1767,6 @@ static int imx565_board_setup(struct imx565 *priv)
 
 		priv->s_data->g_ctx.s_dev = dev;
 
-		mutex_init(&serdes_lock__);
 		err = max96793_sdev_pair(priv->s_data->ser_dev,
 					 &priv->s_data->g_ctx);
 		if (err) {
@@ -1880,13 +1833,52 @@ static const struct v4l2_subdev_internal_ops imx565_subdev_internal_ops = {
 	.open = imx565_open,
 };
 
-static struct tegracam_ctrl_ops imx565_ctrl_ops = {
+static int imx565_set_group_hold_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, bool val)
+{
+	struct imx565 *priv = (struct imx565 *)tc_dev->priv;
+
+	return fr_set_group_hold_ex(&priv->ctrl_blob, blob, REGHOLD, val);
+}
+
+static int imx565_set_gain_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx565 *priv = (struct imx565 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx565_set_gain, val);
+}
+
+static int imx565_set_exposure_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx565 *priv = (struct imx565 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx565_set_exposure, val);
+}
+
+static int imx565_set_frame_rate_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx565 *priv = (struct imx565 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx565_set_frame_rate, val);
+}
+
+static const struct tegracam_ctrl_ops imx565_ctrl_ops = {
 	.numctrls = ARRAY_SIZE(ctrl_cid_list),
 	.ctrl_cid_list = ctrl_cid_list,
 	.set_gain = imx565_set_gain,
 	.set_exposure = imx565_set_exposure,
 	.set_frame_rate = imx565_set_frame_rate,
 	.set_group_hold = imx565_set_group_hold,
+	.set_gain_ex = imx565_set_gain_ex,
+	.set_exposure_ex = imx565_set_exposure_ex,
+	.set_frame_rate_ex = imx565_set_frame_rate_ex,
+	.set_group_hold_ex = imx565_set_group_hold_ex,
 	.set_test_pattern = imx565_set_test_pattern,
 	.set_data_rate = imx565_set_data_rate,
 	.set_operation_mode = imx565_set_operation_mode,
@@ -1927,7 +1919,8 @@ static int imx565_probe(struct i2c_client *client,
 	tc_dev->dev_regmap_config = &sensor_regmap_config;
 	tc_dev->sensor_ops = &imx565_common_ops;
 	tc_dev->v4l2sd_internal_ops = &imx565_subdev_internal_ops;
-	tc_dev->tcctrl_ops = &imx565_ctrl_ops;
+	fr_select_ctrl_ops(&priv->ctrl_ops, &imx565_ctrl_ops);
+	tc_dev->tcctrl_ops = &priv->ctrl_ops;
 
 	err = tegracam_device_register(tc_dev);
 	if (err) {
@@ -1939,6 +1932,17 @@ static int imx565_probe(struct i2c_client *client,
 	priv->subdev = &tc_dev->s_data->subdev;
 	tegracam_set_privdata(tc_dev, (void *)priv);
 
+	err = fr_table_cache_add(dev, &priv->table_cache, mode_table,
+			ARRAY_SIZE(mode_table), IMX565_TABLE_WAIT_MS, IMX565_TABLE_END);
+	if (!err)
+		err = fr_table_cache_add(dev, &priv->table_cache,
+			data_rate_table, ARRAY_SIZE(data_rate_table),
+			IMX565_TABLE_WAIT_MS, IMX565_TABLE_END);
+	if (err) {
+		dev_err(dev, "unable to compile mode tables\n");
+		return err;
+	}
+
 	priv->frame_length = IMX565_DEFAULT_HEIGHT + IMX565_MIN_FRAME_DELTA;
 	priv->current_pixel_format = MEDIA_BUS_FMT_SRGGB12_1X12;
 	priv->line_time = IMX565_DEFAULT_LINE_TIME;
@@ -1982,7 +1986,11 @@ static int imx565_probe(struct i2c_client *client,
 	if (err)
 		return err;
 
+	mutex_lock(&imx565_sensor_list_lock);
 	list_add_tail(&priv->entry, &imx565_sensor_list);
+	mutex_unlock(&imx565_sensor_list_lock);
+
+	fr_stop_debugfs_init(dev, &priv->stream_stop);
 
 	dev_info(dev, "Detected imx565 sensor\n");
 
@@ -2012,12 +2020,10 @@ static void imx565_remove(struct i2c_client *client)
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
 		imx565_gmsl_serdes_reset(priv);
 
+	fr_stop_debugfs_remove(&priv->stream_stop);
 	tegracam_v4l2subdev_unregister(priv->tc_dev);
 	tegracam_device_unregister(priv->tc_dev);
 
-	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
-		mutex_destroy(&serdes_lock__);
-
 #if defined(NV_I2C_DRIVER_STRUCT_REMOVE_RETURN_TYPE_INT) /* Linux 6.1 */
 	return 0;
 #endif
@@ -2032,6 +2038,7 @@ static struct i2c_driver imx565_i2c_driver = {
 		.name = "imx565",
 		.owner = THIS_MODULE,
 		.of_match_table = of_match_ptr(imx565_of_match),
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 	},
 	.probe = imx565_probe,
 	.remove = imx565_remove,
@@ -46,14 +46,12 @@
 #define IMX585_MAX_GAIN_CLEAR_HDR 240
 #define IMX585_MAX_GAIN 720
 
-#define IMX585_4_CSI_LANES 4
 #define IMX585_TWO_LANE_MODE 2
 
 #define IMX585_INCK 74250000LL
 
 LIST_HEAD(imx585_sensor_list);
-
-static struct mutex serdes_lock__;
+static DEFINE_MUTEX(imx585_sensor_list_lock);
 
 static const struct of_device_id imx585_of_match[] = {
 	{ .compatible = "framos,imx585",},
@@ -235,14 +233,17 @@ struct imx585 {
 	struct list_head		entry;
 	struct camera_common_data	*s_data;
 	struct tegracam_device		*tc_dev;
+	struct fr_table_stats		table_stats;
+	struct fr_table_cache		table_cache;
+	struct fr_stop_ctx		stream_stop;
+	struct fr_ctrl_blob		ctrl_blob;
+	struct tegracam_ctrl_ops	ctrl_ops;
 };
 
 static const struct regmap_config sensor_regmap_config = {
 	.reg_bits = 16,
 	.val_bits = 8,
 	.cache_type = REGCACHE_RBTREE,
-	.use_single_read = true,
-	.use_single_write = true,
 };
 
 static bool imx585_is_binning_mode(struct camera_common_data *s_data)
@@ -281,128 +282,32 @@ static int imx585_write_reg(struct camera_common_data *s_data,
 	return err;
 }
 
-static int imx585_write_reg_broadcast(struct camera_common_data *s_data,
-							u16 addr, u8 val)
-{
-	int err;
-	struct device *dev = s_data->dev;
-
-	err = regmap_write(s_data->broadcast_regmap, addr, val);
-	if (err) {
-		dev_err(dev, "%s: i2c write failed, %x = %x\n",
-			__func__, addr, val);
-	}
-
-	return err;
-}
-
 static int imx585_read_buffered_reg(struct camera_common_data *s_data,
 			 u16 addr_low, u8 number_of_registers, u64 *val)
 {
-	struct device *dev = s_data->dev;
-	int err, i;
-	u8 reg;
-
-	*val = 0;
-
-	if (!s_data->group_hold_active) {
-		err = imx585_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: error setting register hold\n",
-				__func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx585_read_reg(s_data, addr_low + i, &reg);
-		*val += reg << (i * 8);
-		if (err) {
-			dev_err(dev, "%s: error reading buffered registers\n",
-				__func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx585_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: error unsetting register hold\n",
-				__func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_read_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx585_write_buffered_reg(struct camera_common_data *s_data,
 				u16 addr_low, u8 number_of_registers, u64 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx585_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx585_write_reg(s_data, addr_low + i, (u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n", __func__);
-			return err;
-		}
-	}
+	struct imx585 *priv = (struct imx585 *)s_data->priv;
 
-	if (!s_data->group_hold_active) {
-		err = imx585_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-			return err;
-		}
-	}
+	if (priv->ctrl_blob.blob)
+		return fr_blob_buffered_reg(&priv->ctrl_blob, REGHOLD,
+			addr_low, number_of_registers, val, false);
 
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 
 static int imx585_broadcast_buffered_reg(struct camera_common_data *s_data,
 				u16 addr_low, u8 number_of_registers, u32 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx585_write_reg_broadcast(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx585_write_reg_broadcast(s_data, addr_low + i,
-					(u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n",
-					__func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx585_write_reg_broadcast(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->broadcast_regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx585_write_table(struct imx585 *priv,
@@ -410,11 +315,9 @@ static int imx585_write_table(struct imx585 *priv,
 {
 	struct camera_common_data *s_data = priv->s_data;
 
-	return regmap_util_write_table_8(s_data->regmap,
-					 table,
-					 NULL, 0,
-					 IMX585_TABLE_WAIT_MS,
-					 IMX585_TABLE_END);
+	return fr_write_table_cached(s_data->regmap, &priv->table_cache,
+				table, IMX585_TABLE_WAIT_MS, IMX585_TABLE_END,
+				&priv->table_stats);
 }
 
 static int imx585_set_group_hold(struct tegracam_device *tc_dev, bool val)
@@ -887,16 +790,19 @@ static bool imx585_find_broadcast_sensor(struct imx585 *broadcast_private)
 {
 	struct imx585 *current_private;
 
+	mutex_lock(&imx585_sensor_list_lock);
 	list_for_each_entry(current_private, &imx585_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		if (current_private->broadcast_ctrl == BROADCAST
 			&& current_private->s_data->power->state == SWITCH_ON) {
 			mutex_unlock(&current_private->pw_mutex);
 			memcpy(broadcast_private, current_private, sizeof(*broadcast_private));
+			mutex_unlock(&imx585_sensor_list_lock);
 			return true;
 		}
 		mutex_unlock(&current_private->pw_mutex);
 	}
+	mutex_unlock(&imx585_sensor_list_lock);
 	return false;
 }
 
@@ -905,6 +811,7 @@ static void imx585_enable_second_slave_address(struct imx585 *ack_private)
 	struct imx585 *current_private;
 	int err;
 
+	mutex_lock(&imx585_sensor_list_lock);
 	list_for_each_entry(current_private, &imx585_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		/* Continue if sensor is in Power-off state */
@@ -924,6 +831,7 @@ static void imx585_enable_second_slave_address(struct imx585 *ack_private)
 		dev_dbg(&current_private->i2c_client->dev,
 				"%s: Sensors 2nd slave address configured\n", __func__);
 	}
+	mutex_unlock(&imx585_sensor_list_lock);
 
 	err = imx585_write_reg(ack_private->s_data,
 								SECOND_SLAVE_ADD, 3);
@@ -940,6 +848,7 @@ static void imx585_disable_second_slave_address(void)
 	struct imx585 *current_private;
 	int err;
 
+	mutex_lock(&imx585_sensor_list_lock);
 	list_for_each_entry(current_private, &imx585_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		if (current_private->s_data->power->state != SWITCH_ON) {
@@ -958,6 +867,7 @@ static void imx585_disable_second_slave_address(void)
 		dev_dbg(&current_private->i2c_client->dev,
 				"%s: Sensors 2nd slave address disabled\n", __func__);
 	}
+	mutex_unlock(&imx585_sensor_list_lock);
 }
 
 static void imx585_configure_second_slave_address(void)
@@ -1134,6 +1044,7 @@ static int imx585_power_off(struct camera_common_data *s_data)
 	}
 
 power_off_done:
+	fr_table_cache_invalidate(s_data->regmap, &priv->table_cache);
 	pw->state = SWITCH_OFF;
 	mutex_unlock(&priv->pw_mutex);
 
@@ -1377,48 +1288,129 @@ static int imx585_calculate_line_time(struct tegracam_device *tc_dev)
 	return 0;
 }
 
+/* HMAX and the data rate used instead of the requested one per ADC mode */
+struct imx585_rate_entry {
+	u16 hmax;
+	u8 data_rate[2];
+};
+
+#define IMX585_RATE_ENTRY(rate, bpp, lanes, hmax_val, linear, clear_hdr) \
+	[IMX585_##rate##_MBPS][FR_BPP_##bpp][FR_LANES_##lanes] = {	\
+		.hmax = hmax_val,					\
+		.data_rate = { linear, clear_hdr },			\
+	}
+
+/* Line timing and supported data rates per pixel depth and lane count */
+static const struct imx585_rate_entry
+imx585_rate_table[IMX585_594_MBPS + 1][FR_NUM_BPP][FR_NUM_LANES] = {
+	IMX585_RATE_ENTRY(2376, 10, 1, 366, IMX585_2376_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(2376, 10, 2, 366, IMX585_1440_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(2376, 10, 4, 366, IMX585_2376_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(2376, 12, 1, 366, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(2376, 12, 2, 366, IMX585_1782_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(2376, 12, 4, 366, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(2376, 16, 1, 366, IMX585_2376_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(2376, 16, 2, 366, IMX585_1782_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(2376, 16, 4, 366, IMX585_2376_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(2079, 10, 1, 366, IMX585_2079_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(2079, 10, 2, 366, IMX585_1440_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(2079, 10, 4, 366, IMX585_2079_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(2079, 12, 1, 366, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(2079, 12, 2, 366, IMX585_1782_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(2079, 12, 4, 366, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(2079, 16, 1, 366, IMX585_2079_MBPS, IMX585_2079_MBPS),
+	IMX585_RATE_ENTRY(2079, 16, 2, 366, IMX585_1782_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(2079, 16, 4, 366, IMX585_2079_MBPS, IMX585_2079_MBPS),
+	IMX585_RATE_ENTRY(1782, 10, 1, 2200, IMX585_2376_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(1782, 10, 2, 1100, IMX585_1440_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(1782, 10, 4, 550, IMX585_2376_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(1782, 12, 1, 2200, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(1782, 12, 2, 1100, IMX585_1782_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(1782, 12, 4, 550, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(1782, 16, 1, 2200, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(1782, 16, 2, 1100, IMX585_1782_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(1782, 16, 4, 550, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(1440, 10, 1, 2200, IMX585_1440_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(1440, 10, 2, 1100, IMX585_1440_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(1440, 10, 4, 550, IMX585_1440_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(1440, 12, 1, 2640, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(1440, 12, 2, 1320, IMX585_1440_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(1440, 12, 4, 660, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(1440, 16, 1, 2640, IMX585_1440_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(1440, 16, 2, 1320, IMX585_1440_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(1440, 16, 4, 660, IMX585_1440_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(1188, 10, 1, 2640, IMX585_1188_MBPS, IMX585_1188_MBPS),
+	IMX585_RATE_ENTRY(1188, 10, 2, 1320, IMX585_1188_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(1188, 10, 4, 660, IMX585_1188_MBPS, IMX585_1188_MBPS),
+	IMX585_RATE_ENTRY(1188, 12, 1, 2640, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(1188, 12, 2, 1320, IMX585_1782_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(1188, 12, 4, 660, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(1188, 16, 1, 2640, IMX585_1188_MBPS, IMX585_1188_MBPS),
+	IMX585_RATE_ENTRY(1188, 16, 2, 1320, IMX585_1188_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(1188, 16, 4, 660, IMX585_1188_MBPS, IMX585_1188_MBPS),
+	IMX585_RATE_ENTRY(891, 10, 1, 1100, IMX585_2376_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(891, 10, 2, 1100, IMX585_1440_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(891, 10, 4, 1100, IMX585_2376_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(891, 12, 1, 1100, IMX585_891_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(891, 12, 2, 1100, IMX585_1782_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(891, 12, 4, 1100, IMX585_891_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(891, 16, 1, 1100, IMX585_891_MBPS, IMX585_891_MBPS),
+	IMX585_RATE_ENTRY(891, 16, 2, 1100, IMX585_1782_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(891, 16, 4, 1100, IMX585_891_MBPS, IMX585_891_MBPS),
+	IMX585_RATE_ENTRY(720, 10, 1, 1100, IMX585_720_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(720, 10, 2, 1100, IMX585_1440_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(720, 10, 4, 1100, IMX585_720_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(720, 12, 1, 1320, IMX585_720_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(720, 12, 2, 1320, IMX585_1782_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(720, 12, 4, 1320, IMX585_720_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(720, 16, 1, 1320, IMX585_720_MBPS, IMX585_720_MBPS),
+	IMX585_RATE_ENTRY(720, 16, 2, 1320, IMX585_1782_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(720, 16, 4, 1320, IMX585_720_MBPS, IMX585_720_MBPS),
+	IMX585_RATE_ENTRY(594, 10, 1, 1320, IMX585_594_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(594, 10, 2, 1320, IMX585_1440_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(594, 10, 4, 1320, IMX585_594_MBPS, IMX585_1440_MBPS),
+	IMX585_RATE_ENTRY(594, 12, 1, 1320, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(594, 12, 2, 1320, IMX585_1782_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(594, 12, 4, 1320, IMX585_1782_MBPS, IMX585_1782_MBPS),
+	IMX585_RATE_ENTRY(594, 16, 1, 1320, IMX585_594_MBPS, IMX585_594_MBPS),
+	IMX585_RATE_ENTRY(594, 16, 2, 1320, IMX585_1782_MBPS, IMX585_2376_MBPS),
+	IMX585_RATE_ENTRY(594, 16, 4, 1320, IMX585_594_MBPS, IMX585_594_MBPS),
+};
+
+static const struct imx585_rate_entry *imx585_lookup_rate_entry(
+					const struct fr_rate_key *key)
+{
+	const struct imx585_rate_entry *entry;
+
+	entry = &imx585_rate_table[key->rate][key->bpp][key->lanes];
+
+	return entry->hmax ? entry : NULL;
+}
+
+static const struct imx585_rate_entry *imx585_get_rate_entry(
+					struct tegracam_device *tc_dev)
+{
+	struct fr_rate_key key;
+
+	if (fr_rate_key_get(tc_dev, ARRAY_SIZE(imx585_rate_table), &key))
+		return NULL;
+
+	return imx585_lookup_rate_entry(&key);
+}
+
 static int imx585_adjust_hmax_register(struct tegracam_device *tc_dev)
 {
 	struct camera_common_data *s_data = tc_dev->s_data;
 	struct device *dev = tc_dev->dev;
+	const struct imx585_rate_entry *entry;
 	int err;
 	u64 hmax = 366;
-	u8 csi_lane_coef = IMX585_4_CSI_LANES / s_data->numlanes;
 
 	dev_dbg(dev, "%s:++\n", __func__);
 
-	switch (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_DATA_RATE, CURRENT)) {
-	case IMX585_2376_MBPS:
-		hmax = 366;
-		break;
-	case IMX585_2079_MBPS:
-		hmax = 366;
-		break;
-	case IMX585_1782_MBPS:
-		hmax = 550 * csi_lane_coef;
-		break;
-	case IMX585_1440_MBPS:
-		if (s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB10_1X10)
-			hmax = 550 * csi_lane_coef;
-		else
-			hmax = 660 * csi_lane_coef;
-		break;
-	case IMX585_1188_MBPS:
-		hmax = 660 * csi_lane_coef;
-		break;
-	case IMX585_891_MBPS:
-		hmax = 1100;
-		break;
-	case IMX585_720_MBPS:
-		if (s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB10_1X10)
-			hmax = 1100;
-		else
-			hmax = 1320;
-		break;
-	case IMX585_594_MBPS:
-		hmax = 1320;
-		break;
-	}
+	entry = imx585_get_rate_entry(tc_dev);
+	if (entry)
+		hmax = entry->hmax;
 
 	if (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_ADC_MODE, CURRENT)) {
 		hmax = (hmax < 550) ? 550 : hmax;
@@ -1485,9 +1477,10 @@ modify_ctrl:
 
 static int imx585_verify_data_rate(struct tegracam_device *tc_dev)
 {
-	struct camera_common_data *s_data = tc_dev->s_data;
 	struct device *dev = tc_dev->dev;
+	const struct imx585_rate_entry *entry;
 	struct v4l2_ctrl *ctrl;
+	bool clear_hdr;
 	u8 data_rate;
 
 	dev_dbg(dev, "%s++\n", __func__);
@@ -1500,112 +1493,16 @@ static int imx585_verify_data_rate(struct tegracam_device *tc_dev)
 	if (ctrl == NULL)
 		return 0;
 
-	if (s_data->numlanes == IMX585_TWO_LANE_MODE) {
-		if (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_ADC_MODE, CURRENT)) {
-			data_rate = IMX585_2376_MBPS;
-			goto modify_ctrl;
-		}
-
-		switch (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_DATA_RATE, CURRENT)) {
-		case IMX585_2376_MBPS:
-		case IMX585_2079_MBPS:
-		case IMX585_891_MBPS:
-		case IMX585_720_MBPS:
-		case IMX585_594_MBPS:
-			dev_warn(dev, "%s: Selected data rate is not supported with 2 CSI lane mode, switching to default!\n", __func__);
-			if (s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB10_1X10) {
-				data_rate = IMX585_1440_MBPS;
-				goto modify_ctrl;
-			} else {
-				data_rate = IMX585_1782_MBPS;
-				goto modify_ctrl;
-			}
-			break;
-		case IMX585_1782_MBPS:
-			if (s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB10_1X10) {
-				data_rate = IMX585_1440_MBPS;
-				goto modify_ctrl;
-			}
-			break;
-		case IMX585_1188_MBPS:
-			if (s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB12_1X12) {
-				data_rate = IMX585_1782_MBPS;
-				goto modify_ctrl;
-			}
-			break;
-		}
-	} else {
-		switch (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_DATA_RATE, CURRENT)) {
-		case IMX585_2376_MBPS:
-		case IMX585_2079_MBPS:
-			if (s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB12_1X12) {
-				data_rate = IMX585_1782_MBPS;
-				goto modify_ctrl;
-			} else if (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_ADC_MODE, CURRENT)
-						&& s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB10_1X10) {
-				data_rate = IMX585_1440_MBPS;
-				goto modify_ctrl;
-			}
-			break;
-		case IMX585_1782_MBPS:
-			if (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_ADC_MODE, CURRENT)
-						&& s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB10_1X10) {
-				data_rate = IMX585_1440_MBPS;
-				goto modify_ctrl;
-			} else if (s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB10_1X10) {
-				data_rate = IMX585_2376_MBPS;
-				goto modify_ctrl;
-			}
-			break;
-		case IMX585_1440_MBPS:
-		case IMX585_1188_MBPS:
-			if (s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB12_1X12) {
-				data_rate = IMX585_1782_MBPS;
-				goto modify_ctrl;
-			}
-			break;
-		case IMX585_891_MBPS:
-			if (s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB10_1X10) {
-				if (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_ADC_MODE, CURRENT)) {
-					data_rate = IMX585_1440_MBPS;
-					goto modify_ctrl;
-				} else {
-					data_rate = IMX585_2376_MBPS;
-					goto modify_ctrl;
-				}
-			} else if (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_ADC_MODE, CURRENT)
-					&& s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB12_1X12) {
-				data_rate = IMX585_1782_MBPS;
-				goto modify_ctrl;
-			}
-			break;
-		case IMX585_720_MBPS:
-			if (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_ADC_MODE, CURRENT)
-					&& s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB12_1X12) {
-				data_rate = IMX585_1782_MBPS;
-				goto modify_ctrl;
-			} else if (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_ADC_MODE, CURRENT)
-					&& s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB10_1X10) {
-				data_rate = IMX585_1440_MBPS;
-				goto modify_ctrl;
-			}
-			break;
-		case IMX585_594_MBPS:
-			if (s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB12_1X12) {
-				data_rate = IMX585_1782_MBPS;
-				goto modify_ctrl;
-			} else if (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_ADC_MODE, CURRENT)
-					&& s_data->colorfmt->code == MEDIA_BUS_FMT_SRGGB10_1X10) {
-				data_rate = IMX585_1440_MBPS;
-				goto modify_ctrl;
-			}
-			break;
-		}
-	}
+	entry = imx585_get_rate_entry(tc_dev);
+	if (!entry)
+		return 0;
 
-	return 0;
+	clear_hdr = !!fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_ADC_MODE,
+								CURRENT);
+	data_rate = entry->data_rate[clear_hdr];
+	if (data_rate == *ctrl->p_cur.p_s64)
+		return 0;
 
-modify_ctrl:
 	dev_warn(dev, "%s: Selected data rate is not supported in this mode, switching to default!\n", __func__);
 	*ctrl->p_new.p_s64 = data_rate;
 	*ctrl->p_cur.p_s64 = data_rate;
@@ -1787,8 +1684,14 @@ static int imx585_set_mode(struct tegracam_device *tc_dev)
 	struct imx585 *priv = (struct imx585 *)tegracam_get_privdata(tc_dev);
 	struct camera_common_data *s_data = tc_dev->s_data;
 	struct device *dev = tc_dev->dev;
+	struct fr_ctrl_snapshot ctrls;
 	int err;
 
+	fr_table_stats_begin(&priv->table_stats);
+	fr_stream_settle(&priv->stream_stop);
+	fr_table_cache_begin_mode(&priv->table_cache);
+	fr_ctrl_snapshot_take(tc_dev, &ctrls);
+
 	err = imx585_write_table(priv, mode_table[IMX585_INIT_SETTINGS]);
 	if (err) {
 		dev_err(dev, "%s: unable to initialize sensor settings\n", __func__);
@@ -1811,8 +1714,7 @@ static int imx585_set_mode(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
-	err = imx585_set_operation_mode(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-				TEGRA_CAMERA_CID_OPERATION_MODE, CURRENT));
+	err = imx585_set_operation_mode(tc_dev, ctrls.operation_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to set operation mode\n", __func__);
 		return err;
@@ -1824,8 +1726,7 @@ static int imx585_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx585_set_sync_mode(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-				TEGRA_CAMERA_CID_SYNC_MODE, CURRENT));
+	err = imx585_set_sync_mode(tc_dev, ctrls.sync_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to set sync mode\n", __func__);
 		return err;
@@ -1844,8 +1745,7 @@ static int imx585_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx585_set_test_pattern(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-				TEGRA_CAMERA_CID_TEST_PATTERN, CURRENT));
+	err = imx585_set_test_pattern(tc_dev, ctrls.test_pattern);
 	if (err) {
 		dev_err(dev, "%s: unable to set Test pattern\n", __func__);
 		return err;
@@ -1874,6 +1774,8 @@ static int imx585_set_mode(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
+	fr_table_cache_end_mode(&priv->table_cache);
+	fr_table_stats_end(dev, &priv->table_stats, s_data->mode);
 	dev_dbg(dev, "%s: set mode %u\n", __func__, s_data->mode);
 
 	return 0;
@@ -1927,6 +1829,8 @@ static int imx585_stop_streaming(struct tegracam_device *tc_dev)
 	struct device *dev = tc_dev->dev;
 	int err;
 
+	fr_stream_stop_begin(&priv->stream_stop);
+
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
 		max96792_stop_streaming(priv->s_data->dser_dev, dev);
 
@@ -1935,8 +1839,8 @@ static int imx585_stop_streaming(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
-	usleep_range(priv->frame_length * priv->line_time / IMX585_K_FACTOR,
-		priv->frame_length * priv->line_time / IMX585_K_FACTOR + 1000);
+	fr_stream_stop_end(&priv->stream_stop,
+		priv->frame_length * priv->line_time / IMX585_K_FACTOR);
 
 	return 0;
 }
@@ -2022,7 +1926,7 @@ static int imx585_gmsl_serdes_setup(struct imx585 *priv)
 
 	dev_dbg(dev, "%s:++n", __func__);
 
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
@@ -2067,20 +1971,20 @@ static int imx585_gmsl_serdes_setup(struct imx585 *priv)
 	}
 
 error:
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 	return err;
 }
 
 static void imx585_gmsl_serdes_reset(struct imx585 *priv)
 {
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96793_reset_control(priv->s_data->ser_dev);
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
 	max96792_power_off(priv->s_data->dser_dev, &priv->s_data->g_ctx);
 
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 }
 
 static int imx585_board_setup(struct imx585 *priv)
@@ -2258,7 +2162,6 @@ static int imx585_board_setup(struct imx585 *priv)
 
 		priv->s_data->g_ctx.s_dev = dev;
 
-		mutex_init(&serdes_lock__);
 		err = max96793_sdev_pair(priv->s_data->ser_dev, &priv->s_data->g_ctx);
 		if (err) {
 			dev_err(dev, "gmsl ser pairing failed\n");
@@ -2328,13 +2231,52 @@ static const struct v4l2_subdev_internal_ops imx585_subdev_internal_ops = {
 	.open = imx585_open,
 };
 
-static struct tegracam_ctrl_ops imx585_ctrl_ops = {
+static int imx585_set_group_hold_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, bool val)
+{
+	struct imx585 *priv = (struct imx585 *)tc_dev->priv;
+
+	return fr_set_group_hold_ex(&priv->ctrl_blob, blob, REGHOLD, val);
+}
+
+static int imx585_set_gain_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx585 *priv = (struct imx585 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx585_set_gain, val);
+}
+
+static int imx585_set_exposure_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx585 *priv = (struct imx585 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx585_set_exposure, val);
+}
+
+static int imx585_set_frame_rate_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx585 *priv = (struct imx585 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx585_set_frame_rate, val);
+}
+
+static const struct tegracam_ctrl_ops imx585_ctrl_ops = {
 	.numctrls = ARRAY_SIZE(ctrl_cid_list),
 	.ctrl_cid_list = ctrl_cid_list,
 	.set_gain = imx585_set_gain,
 	.set_exposure = imx585_set_exposure,
 	.set_frame_rate = imx585_set_frame_rate,
 	.set_group_hold = imx585_set_group_hold,
+	.set_gain_ex = imx585_set_gain_ex,
+	.set_exposure_ex = imx585_set_exposure_ex,
+	.set_frame_rate_ex = imx585_set_frame_rate_ex,
+	.set_group_hold_ex = imx585_set_group_hold_ex,
 	.set_test_pattern = imx585_set_test_pattern,
 	.set_data_rate = imx585_set_data_rate,
 	.set_adc_mode = imx585_set_adc_mode,
@@ -2385,7 +2327,8 @@ static int imx585_probe(struct i2c_client *client, const struct i2c_device_id *i
 	tc_dev->dev_regmap_config = &sensor_regmap_config;
 	tc_dev->sensor_ops = &imx585_common_ops;
 	tc_dev->v4l2sd_internal_ops = &imx585_subdev_internal_ops;
-	tc_dev->tcctrl_ops = &imx585_ctrl_ops;
+	fr_select_ctrl_ops(&priv->ctrl_ops, &imx585_ctrl_ops);
+	tc_dev->tcctrl_ops = &priv->ctrl_ops;
 
 	err = tegracam_device_register(tc_dev);
 	if (err) {
@@ -2397,6 +2340,13 @@ static int imx585_probe(struct i2c_client *client, const struct i2c_device_id *i
 	priv->subdev = &tc_dev->s_data->subdev;
 	tegracam_set_privdata(tc_dev, (void *)priv);
 
+	err = fr_table_cache_add(dev, &priv->table_cache, mode_table,
+			ARRAY_SIZE(mode_table), IMX585_TABLE_WAIT_MS, IMX585_TABLE_END);
+	if (err) {
+		dev_err(dev, "unable to compile mode tables\n");
+		return err;
+	}
+
 	priv->broadcast_ctrl = UNICAST;
 	priv->s_data->broadcast_regmap = NULL;
 	priv->current_pixel_format = MEDIA_BUS_FMT_SRGGB12_1X12;
@@ -2438,7 +2388,11 @@ static int imx585_probe(struct i2c_client *client, const struct i2c_device_id *i
 	if (err)
 		return err;
 
+	mutex_lock(&imx585_sensor_list_lock);
 	list_add_tail(&priv->entry, &imx585_sensor_list);
+	mutex_unlock(&imx585_sensor_list_lock);
+
+	fr_stop_debugfs_init(dev, &priv->stream_stop);
 
 	dev_info(dev, "Detected imx585 sensor\n");
 
@@ -2468,12 +2422,10 @@ static void imx585_remove(struct i2c_client *client)
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
 		imx585_gmsl_serdes_reset(priv);
 
+	fr_stop_debugfs_remove(&priv->stream_stop);
 	tegracam_v4l2subdev_unregister(priv->tc_dev);
 	tegracam_device_unregister(priv->tc_dev);
 
-	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
-		mutex_destroy(&serdes_lock__);
-
 #if defined(NV_I2C_DRIVER_STRUCT_REMOVE_RETURN_TYPE_INT) /* Linux 6.1 */
 	return 0;
 #endif
@@ -2490,6 +2442,7 @@ static struct i2c_driver imx585_i2c_driver = {
 		.name = "imx585",
 		.owner = THIS_MODULE,
 		.of_match_table = of_match_ptr(imx585_of_match),
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 	},
 	.probe = imx585_probe,
 	.remove = imx585_remove,
@@ -2501,3 +2454,7 @@ module_i2c_driver(imx585_i2c_driver);
 MODULE_DESCRIPTION("Media Controller driver for Sony IMX585");
 MODULE_AUTHOR("FRAMOS GmbH");
 MODULE_LICENSE("GPL v2");
+
+#if IS_ENABLED(CONFIG_FR_SENSOR_KUNIT_TEST)
+#include "fr_imx585_kunit.c"
+#endif
@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright (c) 2024 Framos. All rights reserved.
+ *
+ * fr_imx585_kunit.c - KUnit tests of the fr_imx585 data rate table
+ *
+ * Included by fr_imx585.c to reach its static tables.
+ */
+
+#include <kunit/test.h>
+
+/*
+ * HMAX and data rate selection of the driver before the data rate table
+ * was introduced. Kept as the reference every table entry is checked
+ * against. The clear HDR HMAX clamp is applied in code on top of the
+ * table value and is left out.
+ */
+static int imx585_ref_hmax(s64 rate, u32 code, u32 numlanes)
+{
+	u8 csi_lane_coef = 4 / numlanes;
+	int hmax = 366;
+
+	switch (rate) {
+	case IMX585_2376_MBPS:
+		hmax = 366;
+		break;
+	case IMX585_2079_MBPS:
+		hmax = 366;
+		break;
+	case IMX585_1782_MBPS:
+		hmax = 550 * csi_lane_coef;
+		break;
+	case IMX585_1440_MBPS:
+		if (code == MEDIA_BUS_FMT_SRGGB10_1X10)
+			hmax = 550 * csi_lane_coef;
+		else
+			hmax = 660 * csi_lane_coef;
+		break;
+	case IMX585_1188_MBPS:
+		hmax = 660 * csi_lane_coef;
+		break;
+	case IMX585_891_MBPS:
+		hmax = 1100;
+		break;
+	case IMX585_720_MBPS:
+		if (code == MEDIA_BUS_FMT_SRGGB10_1X10)
+			hmax = 1100;
+		else
+			hmax = 1320;
+		break;
+	case IMX585_594_MBPS:
+		hmax = 1320;
+		break;
+	}
+
+	return hmax;
+}
+
+static s64 imx585_ref_data_rate(s64 rate, u32 code, u32 numlanes,
+							bool clear_hdr)
+{
+	if (numlanes == IMX585_TWO_LANE_MODE) {
+		if (clear_hdr)
+			return IMX585_2376_MBPS;
+
+		switch (rate) {
+		case IMX585_2376_MBPS:
+		case IMX585_2079_MBPS:
+		case IMX585_891_MBPS:
+		case IMX585_720_MBPS:
+		case IMX585_594_MBPS:
+			if (code == MEDIA_BUS_FMT_SRGGB10_1X10)
+				return IMX585_1440_MBPS;
+			return IMX585_1782_MBPS;
+		case IMX585_1782_MBPS:
+			if (code == MEDIA_BUS_FMT_SRGGB10_1X10)
+				return IMX585_1440_MBPS;
+			break;
+		case IMX585_1188_MBPS:
+			if (code == MEDIA_BUS_FMT_SRGGB12_1X12)
+				return IMX585_1782_MBPS;
+			break;
+		}
+	} else {
+		switch (rate) {
+		case IMX585_2376_MBPS:
+		case IMX585_2079_MBPS:
+			if (code == MEDIA_BUS_FMT_SRGGB12_1X12)
+				return IMX585_1782_MBPS;
+			else if (clear_hdr && code == MEDIA_BUS_FMT_SRGGB10_1X10)
+				return IMX585_1440_MBPS;
+			break;
+		case IMX585_1782_MBPS:
+			if (clear_hdr && code == MEDIA_BUS_FMT_SRGGB10_1X10)
+				return IMX585_1440_MBPS;
+			else if (code == MEDIA_BUS_FMT_SRGGB10_1X10)
+				return IMX585_2376_MBPS;
+			break;
+		case IMX585_1440_MBPS:
+		case IMX585_1188_MBPS:
+			if (code == MEDIA_BUS_FMT_SRGGB12_1X12)
+				return IMX585_1782_MBPS;
+			break;
+		case IMX585_891_MBPS:
+			if (code == MEDIA_BUS_FMT_SRGGB10_1X10) {
+				if (clear_hdr)
+					return IMX585_1440_MBPS;
+				return IMX585_2376_MBPS;
+			} else if (clear_hdr &&
+					code == MEDIA_BUS_FMT_SRGGB12_1X12) {
+				return IMX585_1782_MBPS;
+			}
+			break;
+		case IMX585_720_MBPS:
+			if (clear_hdr && code == MEDIA_BUS_FMT_SRGGB12_1X12)
+				return IMX585_1782_MBPS;
+			else if (clear_hdr && code == MEDIA_BUS_FMT_SRGGB10_1X10)
+				return IMX585_1440_MBPS;
+			break;
+		case IMX585_594_MBPS:
+			if (code == MEDIA_BUS_FMT_SRGGB12_1X12)
+				return IMX585_1782_MBPS;
+			else if (clear_hdr && code == MEDIA_BUS_FMT_SRGGB10_1X10)
+				return IMX585_1440_MBPS;
+			break;
+		}
+	}
+
+	return rate;
+}
+
+static const u32 imx585_test_codes[] = {
+	MEDIA_BUS_FMT_SRGGB10_1X10,
+	MEDIA_BUS_FMT_SRGGB12_1X12,
+	MEDIA_BUS_FMT_SRGGB16_1X16,
+};
+
+static const u32 imx585_test_lanes[] = { 1, 2, 4 };
+
+static void imx585_check_rate(struct kunit *test, s64 rate, u32 code,
+							u32 numlanes)
+{
+	const struct imx585_rate_entry *entry;
+	struct fr_rate_key key;
+	int clear_hdr;
+
+	KUNIT_ASSERT_EQ(test, fr_rate_key_init(&key,
+			ARRAY_SIZE(imx585_rate_table), rate, code, numlanes), 0);
+
+	entry = imx585_lookup_rate_entry(&key);
+	KUNIT_ASSERT_NOT_NULL_MSG(test, entry, "rate %lld code 0x%x lanes %u",
+						rate, code, numlanes);
+
+	KUNIT_EXPECT_EQ_MSG(test, (int)entry->hmax,
+		imx585_ref_hmax(rate, code, numlanes),
+		"hmax rate %lld code 0x%x lanes %u", rate, code, numlanes);
+
+	for (clear_hdr = 0; clear_hdr <= 1; clear_hdr++)
+		KUNIT_EXPECT_EQ_MSG(test, (s64)entry->data_rate[clear_hdr],
+			imx585_ref_data_rate(rate, code, numlanes, clear_hdr),
+			"data rate %lld code 0x%x lanes %u clear hdr %d",
+			rate, code, numlanes, clear_hdr);
+}
+
+/*
+ * Walk every data rate of the control menu, pixel format and lane count
+ * and check the table lookup against the reference selection.
+ */
+static void imx585_rate_table_test(struct kunit *test)
+{
+	s64 rate;
+	int c, l;
+
+	for (rate = 0; rate < ARRAY_SIZE(imx585_data_rate_menu); rate++)
+		for (c = 0; c < ARRAY_SIZE(imx585_test_codes); c++)
+			for (l = 0; l < ARRAY_SIZE(imx585_test_lanes); l++)
+				imx585_check_rate(test, rate,
+						imx585_test_codes[c],
+						imx585_test_lanes[l]);
+}
+
+static struct kunit_case imx585_rate_test_cases[] = {
+	KUNIT_CASE(imx585_rate_table_test),
+	{}
+};
+
+static struct kunit_suite imx585_rate_test_suite = {
+	.name = "fr_imx585_rate_table",
+	.test_cases = imx585_rate_test_cases,
+};
+
+kunit_test_suite(imx585_rate_test_suite);
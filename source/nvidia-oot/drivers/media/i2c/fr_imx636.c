@@ -46,6 +46,7 @@
 
 
 LIST_HEAD(imx636_sensor_list);
+static DEFINE_MUTEX(imx636_sensor_list_lock);
 
 static const struct of_device_id imx636_of_match[] = {
 	{.compatible = "framos,imx636",},
@@ -1235,7 +1236,9 @@ static int imx636_probe(struct i2c_client *client, const struct i2c_device_id *i
 		return err;
 	}
 
+	mutex_lock(&imx636_sensor_list_lock);
 	list_add_tail(&priv->entry, &imx636_sensor_list);
+	mutex_unlock(&imx636_sensor_list_lock);
 
 	dev_info(dev, "Detected imx636 sensor\n");
 
@@ -1283,6 +1286,7 @@ static struct i2c_driver imx636_i2c_driver = {
 		.name = "imx636",
 		.owner = THIS_MODULE,
 		.of_match_table = of_match_ptr(imx636_of_match),
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 	},
 	.probe = imx636_probe,
 	.remove = imx636_remove,
@@ -53,8 +53,7 @@
 
 
 LIST_HEAD(imx676_sensor_list);
-
-static struct mutex serdes_lock__;
+static DEFINE_MUTEX(imx676_sensor_list_lock);
 
 static const struct of_device_id imx676_of_match[] = {
 	{ .compatible = "framos,imx676",},
@@ -116,14 +115,17 @@ struct imx676 {
 	struct list_head		entry;
 	struct camera_common_data	*s_data;
 	struct tegracam_device		*tc_dev;
+	struct fr_table_stats		table_stats;
+	struct fr_table_cache		table_cache;
+	struct fr_stop_ctx		stream_stop;
+	struct fr_ctrl_blob		ctrl_blob;
+	struct tegracam_ctrl_ops	ctrl_ops;
 };
 
 static const struct regmap_config sensor_regmap_config = {
 	.reg_bits = 16,
 	.val_bits = 8,
 	.cache_type = REGCACHE_RBTREE,
-	.use_single_read = true,
-	.use_single_write = true,
 };
 
 static bool imx676_is_binning_mode(struct camera_common_data *s_data)
@@ -164,140 +166,40 @@ static int imx676_write_reg(struct camera_common_data *s_data,
 	return err;
 }
 
-static int imx676_write_reg_broadcast(struct camera_common_data *s_data,
-							u16 addr, u8 val)
-{
-	int err;
-	struct device *dev = s_data->dev;
-
-	err = regmap_write(s_data->broadcast_regmap, addr, val);
-	if (err) {
-		dev_err(dev, "%s: i2c write failed, %x = %x\n",
-							__func__, addr, val);
-	}
-
-	return err;
-}
-
 static int imx676_read_buffered_reg(struct camera_common_data *s_data,
 			u16 addr_low, u8 number_of_registers, u64 *val)
 {
-	struct device *dev = s_data->dev;
-	int err, i;
-	u8 reg;
-
-	*val = 0;
-
-	if (!s_data->group_hold_active) {
-		err = imx676_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: error setting register hold\n",
-								__func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx676_read_reg(s_data, addr_low + i, &reg);
-		*val += reg << (i * 8);
-		if (err) {
-			dev_err(dev, "%s: error reading buffered registers\n",
-								__func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx676_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: error unsetting register hold\n",
-								__func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_read_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx676_write_buffered_reg(struct camera_common_data *s_data,
 			u16 addr_low, u8 number_of_registers, u64 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx676_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
+	struct imx676 *priv = (struct imx676 *)s_data->priv;
 
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx676_write_reg(s_data, addr_low + i,
-						(u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n",
-								__func__);
-			return err;
-		}
-	}
+	if (priv->ctrl_blob.blob)
+		return fr_blob_buffered_reg(&priv->ctrl_blob, REGHOLD,
+			addr_low, number_of_registers, val, false);
 
-	if (!s_data->group_hold_active) {
-		err = imx676_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx676_broadcast_buffered_reg(struct camera_common_data *s_data,
 				u16 addr_low, u8 number_of_registers, u32 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx676_write_reg_broadcast(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx676_write_reg_broadcast(s_data, addr_low + i,
-			(u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n",
-								__func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx676_write_reg_broadcast(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->broadcast_regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx676_write_table(struct imx676 *priv, const imx676_reg table[])
 {
 	struct camera_common_data *s_data = priv->s_data;
 
-	return regmap_util_write_table_8(s_data->regmap,
-					table,
-					NULL, 0,
-					IMX676_TABLE_WAIT_MS,
-					IMX676_TABLE_END);
+	return fr_write_table_cached(s_data->regmap, &priv->table_cache,
+				table, IMX676_TABLE_WAIT_MS, IMX676_TABLE_END,
+				&priv->table_stats);
 }
 
 static int imx676_set_group_hold(struct tegracam_device *tc_dev, bool val)
@@ -735,6 +637,7 @@ static bool imx676_find_broadcast_sensor(struct imx676 *broadcast_private)
 {
 	struct imx676 *current_private;
 
+	mutex_lock(&imx676_sensor_list_lock);
 	list_for_each_entry(current_private, &imx676_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		if (current_private->broadcast_ctrl == BROADCAST
@@ -742,10 +645,12 @@ static bool imx676_find_broadcast_sensor(struct imx676 *broadcast_private)
 			mutex_unlock(&current_private->pw_mutex);
 			memcpy(broadcast_private, current_private,
 						sizeof(*broadcast_private));
+			mutex_unlock(&imx676_sensor_list_lock);
 			return true;
 		}
 		mutex_unlock(&current_private->pw_mutex);
 	}
+	mutex_unlock(&imx676_sensor_list_lock);
 	return false;
 }
 
@@ -754,6 +659,7 @@ static void imx676_enable_second_slave_address(struct imx676 *ack_private)
 	struct imx676 *current_private;
 	int err;
 
+	mutex_lock(&imx676_sensor_list_lock);
 	list_for_each_entry(current_private, &imx676_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 
@@ -775,6 +681,7 @@ static void imx676_enable_second_slave_address(struct imx676 *ack_private)
 				"%s: Sensors 2nd slave address configured\n",
 								__func__);
 	}
+	mutex_unlock(&imx676_sensor_list_lock);
 
 	err = imx676_write_reg(ack_private->s_data, SECOND_SLAVE_ADD, 3);
 	if (err)
@@ -790,6 +697,7 @@ static void imx676_disable_second_slave_address(void)
 	struct imx676 *current_private;
 	int err;
 
+	mutex_lock(&imx676_sensor_list_lock);
 	list_for_each_entry(current_private, &imx676_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 
@@ -811,6 +719,7 @@ static void imx676_disable_second_slave_address(void)
 				"%s: Sensors 2nd slave address disabled\n",
 								__func__);
 	}
+	mutex_unlock(&imx676_sensor_list_lock);
 }
 
 static void imx676_configure_second_slave_address(void)
@@ -946,6 +855,7 @@ static int imx676_power_off(struct camera_common_data *s_data)
 	}
 
 power_off_done:
+	fr_table_cache_invalidate(s_data->regmap, &priv->table_cache);
 	pw->state = SWITCH_OFF;
 	mutex_unlock(&priv->pw_mutex);
 
@@ -1558,8 +1468,14 @@ static int imx676_set_mode(struct tegracam_device *tc_dev)
 	struct imx676 *priv = (struct imx676 *)tegracam_get_privdata(tc_dev);
 	struct camera_common_data *s_data = tc_dev->s_data;
 	struct device *dev = tc_dev->dev;
+	struct fr_ctrl_snapshot ctrls;
 	int err;
 
+	fr_table_stats_begin(&priv->table_stats);
+	fr_stream_settle(&priv->stream_stop);
+	fr_table_cache_begin_mode(&priv->table_cache);
+	fr_ctrl_snapshot_take(tc_dev, &ctrls);
+
 	dev_dbg(dev, "%s: setting mode %u\n", __func__, s_data->mode);
 
 	err = imx676_write_table(priv, mode_table[IMX676_INIT_SETTINGS]);
@@ -1589,15 +1505,13 @@ static int imx676_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx676_set_operation_mode(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-				TEGRA_CAMERA_CID_OPERATION_MODE, CURRENT));
+	err = imx676_set_operation_mode(tc_dev, ctrls.operation_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to set operation mode\n", __func__);
 		return err;
 	}
 
-	err = imx676_set_sync_mode(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-					TEGRA_CAMERA_CID_SYNC_MODE, CURRENT));
+	err = imx676_set_sync_mode(tc_dev, ctrls.sync_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to set sync mode\n", __func__);
 		return err;
@@ -1616,8 +1530,7 @@ static int imx676_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx676_set_test_pattern(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-				TEGRA_CAMERA_CID_TEST_PATTERN, CURRENT));
+	err = imx676_set_test_pattern(tc_dev, ctrls.test_pattern);
 	if (err) {
 		dev_err(dev, "%s: unable to set Test pattern\n", __func__);
 		return err;
@@ -1643,6 +1556,8 @@ static int imx676_set_mode(struct tegracam_device *tc_dev)
 		dev_err(dev, "%s: unable to update frame range\n", __func__);
 		return err;
 	}
+	fr_table_cache_end_mode(&priv->table_cache);
+	fr_table_stats_end(dev, &priv->table_stats, s_data->mode);
 	dev_dbg(dev, "%s: set mode %u succesfully\n", __func__, s_data->mode);
 
 	return 0;
@@ -1699,6 +1614,8 @@ static int imx676_stop_streaming(struct tegracam_device *tc_dev)
 	struct device *dev = tc_dev->dev;
 	int err;
 
+	fr_stream_stop_begin(&priv->stream_stop);
+
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl"))) {
 		/* disable serdes streaming */
 		max96792_stop_streaming(priv->s_data->dser_dev, dev);
@@ -1710,8 +1627,8 @@ static int imx676_stop_streaming(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	usleep_range(priv->frame_length * priv->line_time / IMX676_K_FACTOR,
-		priv->frame_length * priv->line_time / IMX676_K_FACTOR + 1000);
+	fr_stream_stop_end(&priv->stream_stop,
+		priv->frame_length * priv->line_time / IMX676_K_FACTOR);
 
 	return 0;
 }
@@ -1747,7 +1664,7 @@ static int imx676_gmsl_serdes_setup(struct imx676 *priv)
 
 	dev_dbg(dev, "%s++\n", __func__);
 
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
@@ -1793,20 +1710,20 @@ static int imx676_gmsl_serdes_setup(struct imx676 *priv)
 	}
 
 error:
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 	return err;
 }
 
 static void imx676_gmsl_serdes_reset(struct imx676 *priv)
 {
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96793_reset_control(priv->s_data->ser_dev);
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
 	max96792_power_off(priv->s_data->dser_dev, &priv->s_data->g_ctx);
 
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 }
 
 static int imx676_board_setup(struct imx676 *priv)
@@ -1984,7 +1901,6 @@ static int imx676_board_setup(struct imx676 *priv)
 
 		priv->s_data->g_ctx.s_dev = dev;
 
-		mutex_init(&serdes_lock__);
 
 		err = max96793_sdev_pair(priv->s_data->ser_dev,
 							&priv->s_data->g_ctx);
@@ -2057,13 +1973,52 @@ static const struct v4l2_subdev_internal_ops imx676_subdev_internal_ops = {
 	.open = imx676_open,
 };
 
-static struct tegracam_ctrl_ops imx676_ctrl_ops = {
+static int imx676_set_group_hold_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, bool val)
+{
+	struct imx676 *priv = (struct imx676 *)tc_dev->priv;
+
+	return fr_set_group_hold_ex(&priv->ctrl_blob, blob, REGHOLD, val);
+}
+
+static int imx676_set_gain_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx676 *priv = (struct imx676 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx676_set_gain, val);
+}
+
+static int imx676_set_exposure_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx676 *priv = (struct imx676 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx676_set_exposure, val);
+}
+
+static int imx676_set_frame_rate_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx676 *priv = (struct imx676 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx676_set_frame_rate, val);
+}
+
+static const struct tegracam_ctrl_ops imx676_ctrl_ops = {
 	.numctrls = ARRAY_SIZE(ctrl_cid_list),
 	.ctrl_cid_list = ctrl_cid_list,
 	.set_gain = imx676_set_gain,
 	.set_exposure = imx676_set_exposure,
 	.set_frame_rate = imx676_set_frame_rate,
 	.set_group_hold = imx676_set_group_hold,
+	.set_gain_ex = imx676_set_gain_ex,
+	.set_exposure_ex = imx676_set_exposure_ex,
+	.set_frame_rate_ex = imx676_set_frame_rate_ex,
+	.set_group_hold_ex = imx676_set_group_hold_ex,
 	.set_test_pattern = imx676_set_test_pattern,
 	.set_data_rate = imx676_set_data_rate,
 	.set_operation_mode = imx676_set_operation_mode,
@@ -2108,7 +2063,8 @@ static int imx676_probe(struct i2c_client *client,
 	tc_dev->dev_regmap_config = &sensor_regmap_config;
 	tc_dev->sensor_ops = &imx676_common_ops;
 	tc_dev->v4l2sd_internal_ops = &imx676_subdev_internal_ops;
-	tc_dev->tcctrl_ops = &imx676_ctrl_ops;
+	fr_select_ctrl_ops(&priv->ctrl_ops, &imx676_ctrl_ops);
+	tc_dev->tcctrl_ops = &priv->ctrl_ops;
 
 	err = tegracam_device_register(tc_dev);
 	if (err) {
@@ -2120,6 +2076,13 @@ static int imx676_probe(struct i2c_client *client,
 	priv->subdev = &tc_dev->s_data->subdev;
 	tegracam_set_privdata(tc_dev, (void *)priv);
 
+	err = fr_table_cache_add(dev, &priv->table_cache, mode_table,
+			ARRAY_SIZE(mode_table), IMX676_TABLE_WAIT_MS, IMX676_TABLE_END);
+	if (err) {
+		dev_err(dev, "unable to compile mode tables\n");
+		return err;
+	}
+
 	priv->broadcast_ctrl = UNICAST;
 	priv->s_data->broadcast_regmap = NULL;
 	priv->current_pixel_format = MEDIA_BUS_FMT_SRGGB10_1X10;
@@ -2161,7 +2124,11 @@ static int imx676_probe(struct i2c_client *client,
 	if (err)
 		return err;
 
+	mutex_lock(&imx676_sensor_list_lock);
 	list_add_tail(&priv->entry, &imx676_sensor_list);
+	mutex_unlock(&imx676_sensor_list_lock);
+
+	fr_stop_debugfs_init(dev, &priv->stream_stop);
 
 	dev_info(dev, "Detected imx676 sensor\n");
 
@@ -2192,12 +2159,10 @@ static void imx676_remove(struct i2c_client *client)
 		imx676_gmsl_serdes_reset(priv);
 
 
+	fr_stop_debugfs_remove(&priv->stream_stop);
 	tegracam_v4l2subdev_unregister(priv->tc_dev);
 	tegracam_device_unregister(priv->tc_dev);
 
-	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
-		mutex_destroy(&serdes_lock__);
-
 
 #if defined(NV_I2C_DRIVER_STRUCT_REMOVE_RETURN_TYPE_INT) /* Linux 6.1 */
 	return 0;
@@ -2216,6 +2181,7 @@ static struct i2c_driver imx676_i2c_driver = {
 		.name = "imx676",
 		.owner = THIS_MODULE,
 		.of_match_table = of_match_ptr(imx676_of_match),
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 	},
 	.probe = imx676_probe,
 	.remove = imx676_remove,
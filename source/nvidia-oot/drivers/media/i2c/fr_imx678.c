@@ -53,8 +53,7 @@
 
 
 LIST_HEAD(imx678_sensor_list);
-
-static struct mutex serdes_lock__;
+static DEFINE_MUTEX(imx678_sensor_list_lock);
 
 static const struct of_device_id imx678_of_match[] = {
 	{ .compatible = "framos,imx678",},
@@ -116,14 +115,17 @@ struct imx678 {
 	struct list_head		entry;
 	struct camera_common_data	*s_data;
 	struct tegracam_device		*tc_dev;
+	struct fr_table_stats		table_stats;
+	struct fr_table_cache		table_cache;
+	struct fr_stop_ctx		stream_stop;
+	struct fr_ctrl_blob		ctrl_blob;
+	struct tegracam_ctrl_ops	ctrl_ops;
 };
 
 static const struct regmap_config sensor_regmap_config = {
 	.reg_bits = 16,
 	.val_bits = 8,
 	.cache_type = REGCACHE_RBTREE,
-	.use_single_read = true,
-	.use_single_write = true,
 };
 
 static bool imx678_is_binning_mode(struct camera_common_data *s_data)
@@ -163,139 +165,40 @@ static int imx678_write_reg(struct camera_common_data *s_data,
 	return err;
 }
 
-static int imx678_write_reg_broadcast(struct camera_common_data *s_data,
-							u16 addr, u8 val)
-{
-	int err;
-	struct device *dev = s_data->dev;
-
-	err = regmap_write(s_data->broadcast_regmap, addr, val);
-	if (err) {
-		dev_err(dev, "%s: i2c write failed, %x = %x\n",
-						__func__, addr, val);
-	}
-
-	return err;
-}
-
 static int imx678_read_buffered_reg(struct camera_common_data *s_data,
 			u16 addr_low, u8 number_of_registers, u64 *val)
 {
-	struct device *dev = s_data->dev;
-	int err, i;
-	u8 reg;
-	*val = 0;
-
-	if (!s_data->group_hold_active) {
-		err = imx678_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: error setting register hold\n",
-								__func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx678_read_reg(s_data, addr_low + i, &reg);
-		*val += reg << (i * 8);
-		if (err) {
-			dev_err(dev, "%s: error reading buffered registers\n",
-								__func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx678_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: error unsetting register hold\n",
-								__func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_read_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx678_write_buffered_reg(struct camera_common_data *s_data,
 			u16 addr_low, u8 number_of_registers, u64 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx678_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx678_write_reg(s_data, addr_low + i,
-						(u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n",
-								__func__);
-			return err;
-		}
-	}
+	struct imx678 *priv = (struct imx678 *)s_data->priv;
 
-	if (!s_data->group_hold_active) {
-		err = imx678_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-			return err;
-		}
-	}
+	if (priv->ctrl_blob.blob)
+		return fr_blob_buffered_reg(&priv->ctrl_blob, REGHOLD,
+			addr_low, number_of_registers, val, false);
 
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx678_broadcast_buffered_reg(struct camera_common_data *s_data,
 			u16 addr_low, u8 number_of_registers, u32 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx678_write_reg_broadcast(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx678_write_reg_broadcast(s_data, addr_low + i,
-			(u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n",
-								__func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx678_write_reg_broadcast(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->broadcast_regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx678_write_table(struct imx678 *priv, const imx678_reg table[])
 {
 	struct camera_common_data *s_data = priv->s_data;
 
-	return regmap_util_write_table_8(s_data->regmap,
-					 table,
-					 NULL, 0,
-					 IMX678_TABLE_WAIT_MS,
-					 IMX678_TABLE_END);
+	return fr_write_table_cached(s_data->regmap, &priv->table_cache,
+				table, IMX678_TABLE_WAIT_MS, IMX678_TABLE_END,
+				&priv->table_stats);
 }
 
 static int imx678_set_group_hold(struct tegracam_device *tc_dev, bool val)
@@ -721,6 +624,7 @@ static bool imx678_find_broadcast_sensor(struct imx678 *broadcast_private)
 {
 	struct imx678 *current_private;
 
+	mutex_lock(&imx678_sensor_list_lock);
 	list_for_each_entry(current_private, &imx678_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		if (current_private->broadcast_ctrl == BROADCAST
@@ -728,10 +632,12 @@ static bool imx678_find_broadcast_sensor(struct imx678 *broadcast_private)
 			mutex_unlock(&current_private->pw_mutex);
 			memcpy(broadcast_private, current_private,
 						sizeof(*broadcast_private));
+			mutex_unlock(&imx678_sensor_list_lock);
 			return true;
 		}
 		mutex_unlock(&current_private->pw_mutex);
 	}
+	mutex_unlock(&imx678_sensor_list_lock);
 	return false;
 }
 
@@ -740,6 +646,7 @@ static void imx678_enable_second_slave_address(struct imx678 *ack_private)
 	struct imx678 *current_private;
 	int err;
 
+	mutex_lock(&imx678_sensor_list_lock);
 	list_for_each_entry(current_private, &imx678_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 
@@ -760,6 +667,7 @@ static void imx678_enable_second_slave_address(struct imx678 *ack_private)
 	dev_dbg(&current_private->i2c_client->dev,
 		"%s: Sensors 2nd slave address configured\n", __func__);
 	}
+	mutex_unlock(&imx678_sensor_list_lock);
 
 	err = imx678_write_reg(ack_private->s_data, SECOND_SLAVE_ADD, 3);
 	if (err)
@@ -775,6 +683,7 @@ static void imx678_disable_second_slave_address(void)
 	struct imx678 *current_private;
 	int err;
 
+	mutex_lock(&imx678_sensor_list_lock);
 	list_for_each_entry(current_private, &imx678_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 
@@ -796,6 +705,7 @@ static void imx678_disable_second_slave_address(void)
 				"%s: Sensors 2nd slave address disabled\n",
 								__func__);
 	}
+	mutex_unlock(&imx678_sensor_list_lock);
 }
 
 static void imx678_configure_second_slave_address(void)
@@ -932,6 +842,7 @@ static int imx678_power_off(struct camera_common_data *s_data)
 	}
 
 power_off_done:
+	fr_table_cache_invalidate(s_data->regmap, &priv->table_cache);
 	pw->state = SWITCH_OFF;
 	mutex_unlock(&priv->pw_mutex);
 
@@ -1534,8 +1445,14 @@ static int imx678_set_mode(struct tegracam_device *tc_dev)
 	struct imx678 *priv = (struct imx678 *)tegracam_get_privdata(tc_dev);
 	struct camera_common_data *s_data = tc_dev->s_data;
 	struct device *dev = tc_dev->dev;
+	struct fr_ctrl_snapshot ctrls;
 	int err;
 
+	fr_table_stats_begin(&priv->table_stats);
+	fr_stream_settle(&priv->stream_stop);
+	fr_table_cache_begin_mode(&priv->table_cache);
+	fr_ctrl_snapshot_take(tc_dev, &ctrls);
+
 	dev_dbg(dev, "%s: setting mode %u\n", __func__, s_data->mode);
 
 	err = imx678_write_table(priv, mode_table[IMX678_INIT_SETTINGS]);
@@ -1566,15 +1483,13 @@ static int imx678_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx678_set_operation_mode(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-				TEGRA_CAMERA_CID_OPERATION_MODE, CURRENT));
+	err = imx678_set_operation_mode(tc_dev, ctrls.operation_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to set operation mode\n", __func__);
 		return err;
 	}
 
-	err = imx678_set_sync_mode(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-				TEGRA_CAMERA_CID_SYNC_MODE, CURRENT));
+	err = imx678_set_sync_mode(tc_dev, ctrls.sync_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to set sync mode\n", __func__);
 		return err;
@@ -1593,8 +1508,7 @@ static int imx678_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx678_set_test_pattern(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-				TEGRA_CAMERA_CID_TEST_PATTERN, CURRENT));
+	err = imx678_set_test_pattern(tc_dev, ctrls.test_pattern);
 	if (err) {
 		dev_err(dev, "%s: unable to set Test pattern\n", __func__);
 		return err;
@@ -1620,6 +1534,8 @@ static int imx678_set_mode(struct tegracam_device *tc_dev)
 		dev_err(dev, "%s: unable to update frame range\n", __func__);
 		return err;
 	}
+	fr_table_cache_end_mode(&priv->table_cache);
+	fr_table_stats_end(dev, &priv->table_stats, s_data->mode);
 	dev_dbg(dev, "%s: set mode %u succesfully\n", __func__, s_data->mode);
 
 	return 0;
@@ -1674,6 +1590,8 @@ static int imx678_stop_streaming(struct tegracam_device *tc_dev)
 	struct device *dev = tc_dev->dev;
 	int err;
 
+	fr_stream_stop_begin(&priv->stream_stop);
+
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl"))) {
 		/* disable serdes streaming */
 		max96792_stop_streaming(priv->s_data->dser_dev, dev);
@@ -1682,8 +1600,8 @@ static int imx678_stop_streaming(struct tegracam_device *tc_dev)
 	err = imx678_write_table(priv, mode_table[IMX678_MODE_STOP_STREAM]);
 	if (err)
 		return err;
-	usleep_range(priv->frame_length * priv->line_time / IMX678_K_FACTOR,
-		priv->frame_length * priv->line_time / IMX678_K_FACTOR + 1000);
+	fr_stream_stop_end(&priv->stream_stop,
+		priv->frame_length * priv->line_time / IMX678_K_FACTOR);
 
 	return 0;
 }
@@ -1718,7 +1636,7 @@ static int imx678_gmsl_serdes_setup(struct imx678 *priv)
 
 	dev_dbg(dev, "%s++\n", __func__);
 
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
@@ -1763,20 +1681,20 @@ static int imx678_gmsl_serdes_setup(struct imx678 *priv)
 	}
 
 error:
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 	return err;
 }
 
 static void imx678_gmsl_serdes_reset(struct imx678 *priv)
 {
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96793_reset_control(priv->s_data->ser_dev);
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
 	max96792_power_off(priv->s_data->dser_dev, &priv->s_data->g_ctx);
 
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 }
 
 static int imx678_board_setup(struct imx678 *priv)
@@ -1954,7 +1872,6 @@ static int imx678_board_setup(struct imx678 *priv)
 
 		priv->s_data->g_ctx.s_dev = dev;
 
-		mutex_init(&serdes_lock__);
 
 		err = max96793_sdev_pair(priv->s_data->ser_dev,
 							&priv->s_data->g_ctx);
@@ -2028,13 +1945,52 @@ static const struct v4l2_subdev_internal_ops imx678_subdev_internal_ops = {
 	.open = imx678_open,
 };
 
-static struct tegracam_ctrl_ops imx678_ctrl_ops = {
+static int imx678_set_group_hold_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, bool val)
+{
+	struct imx678 *priv = (struct imx678 *)tc_dev->priv;
+
+	return fr_set_group_hold_ex(&priv->ctrl_blob, blob, REGHOLD, val);
+}
+
+static int imx678_set_gain_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx678 *priv = (struct imx678 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx678_set_gain, val);
+}
+
+static int imx678_set_exposure_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx678 *priv = (struct imx678 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx678_set_exposure, val);
+}
+
+static int imx678_set_frame_rate_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx678 *priv = (struct imx678 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx678_set_frame_rate, val);
+}
+
+static const struct tegracam_ctrl_ops imx678_ctrl_ops = {
 	.numctrls = ARRAY_SIZE(ctrl_cid_list),
 	.ctrl_cid_list = ctrl_cid_list,
 	.set_gain = imx678_set_gain,
 	.set_exposure = imx678_set_exposure,
 	.set_frame_rate = imx678_set_frame_rate,
 	.set_group_hold = imx678_set_group_hold,
+	.set_gain_ex = imx678_set_gain_ex,
+	.set_exposure_ex = imx678_set_exposure_ex,
+	.set_frame_rate_ex = imx678_set_frame_rate_ex,
+	.set_group_hold_ex = imx678_set_group_hold_ex,
 	.set_test_pattern = imx678_set_test_pattern,
 	.set_data_rate = imx678_set_data_rate,
 	.set_operation_mode = imx678_set_operation_mode,
@@ -2079,7 +2035,8 @@ static int imx678_probe(struct i2c_client *client,
 	tc_dev->dev_regmap_config = &sensor_regmap_config;
 	tc_dev->sensor_ops = &imx678_common_ops;
 	tc_dev->v4l2sd_internal_ops = &imx678_subdev_internal_ops;
-	tc_dev->tcctrl_ops = &imx678_ctrl_ops;
+	fr_select_ctrl_ops(&priv->ctrl_ops, &imx678_ctrl_ops);
+	tc_dev->tcctrl_ops = &priv->ctrl_ops;
 
 	err = tegracam_device_register(tc_dev);
 	if (err) {
@@ -2091,6 +2048,13 @@ static int imx678_probe(struct i2c_client *client,
 	priv->subdev = &tc_dev->s_data->subdev;
 	tegracam_set_privdata(tc_dev, (void *)priv);
 
+	err = fr_table_cache_add(dev, &priv->table_cache, mode_table,
+			ARRAY_SIZE(mode_table), IMX678_TABLE_WAIT_MS, IMX678_TABLE_END);
+	if (err) {
+		dev_err(dev, "unable to compile mode tables\n");
+		return err;
+	}
+
 	priv->broadcast_ctrl = UNICAST;
 	priv->s_data->broadcast_regmap = NULL;
 	priv->current_pixel_format = MEDIA_BUS_FMT_SRGGB12_1X12;
@@ -2132,7 +2096,11 @@ static int imx678_probe(struct i2c_client *client,
 	if (err)
 		return err;
 
+	mutex_lock(&imx678_sensor_list_lock);
 	list_add_tail(&priv->entry, &imx678_sensor_list);
+	mutex_unlock(&imx678_sensor_list_lock);
+
+	fr_stop_debugfs_init(dev, &priv->stream_stop);
 
 	dev_info(dev, "Detected imx678 sensor\n");
 
@@ -2162,12 +2130,10 @@ static void imx678_remove(struct i2c_client *client)
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
 		imx678_gmsl_serdes_reset(priv);
 
+	fr_stop_debugfs_remove(&priv->stream_stop);
 	tegracam_v4l2subdev_unregister(priv->tc_dev);
 	tegracam_device_unregister(priv->tc_dev);
 
-	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
-		mutex_destroy(&serdes_lock__);
-
 
 #if defined(NV_I2C_DRIVER_STRUCT_REMOVE_RETURN_TYPE_INT) /* Linux 6.1 */
 	return 0;
@@ -2186,6 +2152,7 @@ static struct i2c_driver imx678_i2c_driver = {
 		.name = "imx678",
 		.owner = THIS_MODULE,
 		.of_match_table = of_match_ptr(imx678_of_match),
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 	},
 	.probe = imx678_probe,
 	.remove = imx678_remove,
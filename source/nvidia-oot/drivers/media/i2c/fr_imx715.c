@@ -51,8 +51,7 @@
 #define IMX715_2ND_INCK 72000000LL
 
 LIST_HEAD(imx715_sensor_list);
-
-static struct mutex serdes_lock__;
+static DEFINE_MUTEX(imx715_sensor_list_lock);
 
 static const struct of_device_id imx715_of_match[] = {
 	{ .compatible = "framos,imx715",},
@@ -112,14 +111,17 @@ struct imx715 {
 	struct list_head		entry;
 	struct camera_common_data	*s_data;
 	struct tegracam_device		*tc_dev;
+	struct fr_table_stats		table_stats;
+	struct fr_table_cache		table_cache;
+	struct fr_stop_ctx		stream_stop;
+	struct fr_ctrl_blob		ctrl_blob;
+	struct tegracam_ctrl_ops	ctrl_ops;
 };
 
 static const struct regmap_config sensor_regmap_config = {
 	.reg_bits = 16,
 	.val_bits = 8,
 	.cache_type = REGCACHE_RBTREE,
-	.use_single_read = true,
-	.use_single_write = true,
 };
 
 static inline int imx715_read_reg(struct camera_common_data *s_data, u16 addr,
@@ -147,135 +149,41 @@ static int imx715_write_reg(struct camera_common_data *s_data, u16 addr, u8 val)
 	return err;
 }
 
-static int imx715_write_reg_broadcast(struct camera_common_data *s_data,
-							u16 addr, u8 val)
-{
-	int err;
-	struct device *dev = s_data->dev;
-
-	err = regmap_write(s_data->broadcast_regmap, addr, val);
-	if (err) {
-		dev_err(dev, "%s: i2c write failed, %x = %x\n",
-			__func__, addr, val);
-	}
-
-	return err;
-}
-
 static int imx715_read_buffered_reg(struct camera_common_data *s_data,
 				u16 addr_low, u8 number_of_registers, u64 *val)
 {
-	struct device *dev = s_data->dev;
-	int err, i;
-	u8 reg;
-
-	*val = 0;
-
-	if (!s_data->group_hold_active) {
-		err = imx715_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: error setting register hold\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx715_read_reg(s_data, addr_low + i, &reg);
-		*val += reg << (i * 8);
-		if (err) {
-			dev_err(dev, "%s: error reading buffered registers\n", __func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx715_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: error unsetting register hold\n", __func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_read_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx715_write_buffered_reg(struct camera_common_data *s_data,
 				u16 addr_low, u8 number_of_registers, u64 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx715_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx715_write_reg(s_data, addr_low + i, (u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n", __func__);
-			return err;
-		}
-	}
+	struct imx715 *priv = (struct imx715 *)s_data->priv;
 
-	if (!s_data->group_hold_active) {
-		err = imx715_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-			return err;
-		}
-	}
+	if (priv->ctrl_blob.blob)
+		return fr_blob_buffered_reg(&priv->ctrl_blob, REGHOLD,
+			addr_low, number_of_registers, val, false);
 
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 
 static int imx715_broadcast_buffered_reg(struct camera_common_data *s_data,
 				u16 addr_low, u8 number_of_registers, u32 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx715_write_reg_broadcast(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx715_write_reg_broadcast(s_data, addr_low + i,
-					(u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n", __func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx715_write_reg_broadcast(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-			return err;
-		}
-	}
-
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->broadcast_regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx715_write_table(struct imx715 *priv, const imx715_reg table[])
 {
 	struct camera_common_data *s_data = priv->s_data;
 
-	return regmap_util_write_table_8(s_data->regmap,
-					 table,
-					 NULL, 0,
-					 IMX715_TABLE_WAIT_MS,
-					 IMX715_TABLE_END);
+	return fr_write_table_cached(s_data->regmap, &priv->table_cache,
+				table, IMX715_TABLE_WAIT_MS, IMX715_TABLE_END,
+				&priv->table_stats);
 }
 
 static int imx715_set_group_hold(struct tegracam_device *tc_dev, bool val)
@@ -630,16 +538,19 @@ static bool imx715_find_broadcast_sensor(struct imx715 *broadcast_private)
 {
 	struct imx715 *current_private;
 
+	mutex_lock(&imx715_sensor_list_lock);
 	list_for_each_entry(current_private, &imx715_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		if (current_private->broadcast_ctrl == BROADCAST
 			&& current_private->s_data->power->state == SWITCH_ON) {
 			mutex_unlock(&current_private->pw_mutex);
 			memcpy(broadcast_private, current_private, sizeof(*broadcast_private));
+			mutex_unlock(&imx715_sensor_list_lock);
 			return true;
 		}
 		mutex_unlock(&current_private->pw_mutex);
 	}
+	mutex_unlock(&imx715_sensor_list_lock);
 	return false;
 }
 
@@ -648,6 +559,7 @@ static void imx715_enable_second_slave_address(struct imx715 *ack_private)
 	struct imx715 *current_private;
 	int err;
 
+	mutex_lock(&imx715_sensor_list_lock);
 	list_for_each_entry(current_private, &imx715_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		if (current_private->s_data->power->state != SWITCH_ON) {
@@ -666,6 +578,7 @@ static void imx715_enable_second_slave_address(struct imx715 *ack_private)
 		dev_dbg(&current_private->i2c_client->dev,
 				"%s: Sensors 2nd slave address configured\n", __func__);
 	}
+	mutex_unlock(&imx715_sensor_list_lock);
 
 	err = imx715_write_reg(ack_private->s_data,
 							SECOND_SLAVE_ADD, 3);
@@ -682,6 +595,7 @@ static void imx715_disable_second_slave_address(void)
 	struct imx715 *current_private;
 	int err;
 
+	mutex_lock(&imx715_sensor_list_lock);
 	list_for_each_entry(current_private, &imx715_sensor_list, entry) {
 		mutex_lock(&current_private->pw_mutex);
 		if (current_private->s_data->power->state != SWITCH_ON) {
@@ -700,6 +614,7 @@ static void imx715_disable_second_slave_address(void)
 		dev_dbg(&current_private->i2c_client->dev,
 				"%s: Sensors 2nd slave address disabled\n", __func__);
 	}
+	mutex_unlock(&imx715_sensor_list_lock);
 }
 
 static void imx715_configure_second_slave_address(void)
@@ -837,6 +752,7 @@ static int imx715_power_off(struct camera_common_data *s_data)
 
 
 power_off_done:
+	fr_table_cache_invalidate(s_data->regmap, &priv->table_cache);
 	pw->state = SWITCH_OFF;
 	mutex_unlock(&priv->pw_mutex);
 
@@ -1436,8 +1352,14 @@ static int imx715_set_mode(struct tegracam_device *tc_dev)
 	struct imx715 *priv = (struct imx715 *)tegracam_get_privdata(tc_dev);
 	struct camera_common_data *s_data = tc_dev->s_data;
 	struct device *dev = tc_dev->dev;
+	struct fr_ctrl_snapshot ctrls;
 	int err;
 
+	fr_table_stats_begin(&priv->table_stats);
+	fr_stream_settle(&priv->stream_stop);
+	fr_table_cache_begin_mode(&priv->table_cache);
+	fr_ctrl_snapshot_take(tc_dev, &ctrls);
+
 	err = imx715_write_table(priv, mode_table[IMX715_INIT_SETTINGS]);
 	if (err) {
 		dev_err(dev, "%s: unable to initialize sensor settings\n", __func__);
@@ -1460,15 +1382,13 @@ static int imx715_set_mode(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
-	err = imx715_set_operation_mode(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-					TEGRA_CAMERA_CID_OPERATION_MODE, CURRENT));
+	err = imx715_set_operation_mode(tc_dev, ctrls.operation_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to set operation mode\n", __func__);
 		return err;
 	}
 
-	err = imx715_set_sync_mode(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-					TEGRA_CAMERA_CID_SYNC_MODE, CURRENT));
+	err = imx715_set_sync_mode(tc_dev, ctrls.sync_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to set sync mode\n", __func__);
 		return err;
@@ -1487,8 +1407,7 @@ static int imx715_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx715_set_test_pattern(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-					TEGRA_CAMERA_CID_TEST_PATTERN, CURRENT));
+	err = imx715_set_test_pattern(tc_dev, ctrls.test_pattern);
 	if (err) {
 		dev_err(dev, "%s: unable to set Test pattern\n", __func__);
 		return err;
@@ -1511,6 +1430,8 @@ static int imx715_set_mode(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
+	fr_table_cache_end_mode(&priv->table_cache);
+	fr_table_stats_end(dev, &priv->table_stats, s_data->mode);
 	dev_dbg(dev, "%s: set mode %u\n", __func__, s_data->mode);
 
 	return 0;
@@ -1564,6 +1485,8 @@ static int imx715_stop_streaming(struct tegracam_device *tc_dev)
 	struct device *dev = tc_dev->dev;
 	int err;
 
+	fr_stream_stop_begin(&priv->stream_stop);
+
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
 		max96792_stop_streaming(priv->s_data->dser_dev, dev);
 
@@ -1571,8 +1494,8 @@ static int imx715_stop_streaming(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
-	usleep_range(priv->frame_length * priv->line_time / IMX715_K_FACTOR,
-		priv->frame_length * priv->line_time / IMX715_K_FACTOR + 1000);
+	fr_stream_stop_end(&priv->stream_stop,
+		priv->frame_length * priv->line_time / IMX715_K_FACTOR);
 
 	return 0;
 }
@@ -1607,7 +1530,7 @@ static int imx715_gmsl_serdes_setup(struct imx715 *priv)
 
 	dev_dbg(dev, "%s: ++\n", __func__);
 
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
@@ -1653,20 +1576,20 @@ static int imx715_gmsl_serdes_setup(struct imx715 *priv)
 	}
 
 error:
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 	return err;
 }
 
 static void imx715_gmsl_serdes_reset(struct imx715 *priv)
 {
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96793_reset_control(priv->s_data->ser_dev);
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
 	max96792_power_off(priv->s_data->dser_dev, &priv->s_data->g_ctx);
 
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 }
 
 static int imx715_board_setup(struct imx715 *priv)
@@ -1844,7 +1767,6 @@ static int imx715_board_setup(struct imx715 *priv)
 
 		priv->s_data->g_ctx.s_dev = dev;
 
-		mutex_init(&serdes_lock__);
 		err = max96793_sdev_pair(priv->s_data->ser_dev, &priv->s_data->g_ctx);
 		if (err) {
 			dev_err(dev, "gmsl ser pairing failed\n");
@@ -1913,13 +1835,52 @@ static const struct v4l2_subdev_internal_ops imx715_subdev_internal_ops = {
 	.open = imx715_open,
 };
 
-static struct tegracam_ctrl_ops imx715_ctrl_ops = {
+static int imx715_set_group_hold_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, bool val)
+{
+	struct imx715 *priv = (struct imx715 *)tc_dev->priv;
+
+	return fr_set_group_hold_ex(&priv->ctrl_blob, blob, REGHOLD, val);
+}
+
+static int imx715_set_gain_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx715 *priv = (struct imx715 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx715_set_gain, val);
+}
+
+static int imx715_set_exposure_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx715 *priv = (struct imx715 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx715_set_exposure, val);
+}
+
+static int imx715_set_frame_rate_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx715 *priv = (struct imx715 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx715_set_frame_rate, val);
+}
+
+static const struct tegracam_ctrl_ops imx715_ctrl_ops = {
 	.numctrls = ARRAY_SIZE(ctrl_cid_list),
 	.ctrl_cid_list = ctrl_cid_list,
 	.set_gain = imx715_set_gain,
 	.set_exposure = imx715_set_exposure,
 	.set_frame_rate = imx715_set_frame_rate,
 	.set_group_hold = imx715_set_group_hold,
+	.set_gain_ex = imx715_set_gain_ex,
+	.set_exposure_ex = imx715_set_exposure_ex,
+	.set_frame_rate_ex = imx715_set_frame_rate_ex,
+	.set_group_hold_ex = imx715_set_group_hold_ex,
 	.set_test_pattern = imx715_set_test_pattern,
 	.set_data_rate = imx715_set_data_rate,
 	.set_operation_mode = imx715_set_operation_mode,
@@ -1962,7 +1923,8 @@ static int imx715_probe(struct i2c_client *client, const struct i2c_device_id *i
 	tc_dev->dev_regmap_config = &sensor_regmap_config;
 	tc_dev->sensor_ops = &imx715_common_ops;
 	tc_dev->v4l2sd_internal_ops = &imx715_subdev_internal_ops;
-	tc_dev->tcctrl_ops = &imx715_ctrl_ops;
+	fr_select_ctrl_ops(&priv->ctrl_ops, &imx715_ctrl_ops);
+	tc_dev->tcctrl_ops = &priv->ctrl_ops;
 
 	err = tegracam_device_register(tc_dev);
 	if (err) {
@@ -1975,6 +1937,17 @@ static int imx715_probe(struct i2c_client *client, const struct i2c_device_id *i
 	priv->subdev = &tc_dev->s_data->subdev;
 	tegracam_set_privdata(tc_dev, (void *)priv);
 
+	err = fr_table_cache_add(dev, &priv->table_cache, mode_table,
+			ARRAY_SIZE(mode_table), IMX715_TABLE_WAIT_MS, IMX715_TABLE_END);
+	if (!err)
+		err = fr_table_cache_add(dev, &priv->table_cache,
+			data_rate_table, ARRAY_SIZE(data_rate_table),
+			IMX715_TABLE_WAIT_MS, IMX715_TABLE_END);
+	if (err) {
+		dev_err(dev, "unable to compile mode tables\n");
+		return err;
+	}
+
 	priv->broadcast_ctrl = UNICAST;
 	priv->s_data->broadcast_regmap = NULL;
 
@@ -2017,7 +1990,11 @@ static int imx715_probe(struct i2c_client *client, const struct i2c_device_id *i
 	if (err)
 		return err;
 
+	mutex_lock(&imx715_sensor_list_lock);
 	list_add_tail(&priv->entry, &imx715_sensor_list);
+	mutex_unlock(&imx715_sensor_list_lock);
+
+	fr_stop_debugfs_init(dev, &priv->stream_stop);
 
 	dev_info(dev, "Detected imx715 sensor\n");
 
@@ -2047,12 +2024,10 @@ static void imx715_remove(struct i2c_client *client)
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
 		imx715_gmsl_serdes_reset(priv);
 
+	fr_stop_debugfs_remove(&priv->stream_stop);
 	tegracam_v4l2subdev_unregister(priv->tc_dev);
 	tegracam_device_unregister(priv->tc_dev);
 
-	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
-		mutex_destroy(&serdes_lock__);
-
 #if defined(NV_I2C_DRIVER_STRUCT_REMOVE_RETURN_TYPE_INT) /* Linux 6.1 */
 	return 0;
 #endif
@@ -2069,6 +2044,7 @@ static struct i2c_driver imx715_i2c_driver = {
 		.name = "imx715",
 		.owner = THIS_MODULE,
 		.of_match_table = of_match_ptr(imx715_of_match),
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 	},
 	.probe = imx715_probe,
 	.remove = imx715_remove,
@@ -55,8 +55,7 @@
 
 
 LIST_HEAD(imx900_sensor_list);
-
-static struct mutex serdes_lock__;
+static DEFINE_MUTEX(imx900_sensor_list_lock);
 
 static const struct of_device_id imx900_of_match[] = {
 	{ .compatible = "framos,imx900",},
@@ -105,6 +104,11 @@ struct imx900 {
 	struct camera_common_data	*s_data;
 	struct tegracam_device		*tc_dev;
 	u8				chromacity;
+	struct fr_table_stats		table_stats;
+	struct fr_table_cache		table_cache;
+	struct fr_stop_ctx		stream_stop;
+	struct fr_ctrl_blob		ctrl_blob;
+	struct tegracam_ctrl_ops	ctrl_ops;
 };
 
 static bool imx900_is_volatile_reg(struct device *dev, unsigned int reg)
@@ -121,8 +125,6 @@ static const struct regmap_config sensor_regmap_config = {
 	.reg_bits = 16,
 	.val_bits = 8,
 	.cache_type = REGCACHE_RBTREE,
-	.use_single_read = true,
-	.use_single_write = true,
 	.volatile_reg = imx900_is_volatile_reg,
 };
 
@@ -155,87 +157,30 @@ static int imx900_write_reg(struct camera_common_data *s_data,
 static int imx900_read_buffered_reg(struct camera_common_data *s_data,
 			u16 addr_low, u8 number_of_registers, u64 *val)
 {
-	struct device *dev = s_data->dev;
-	int err, i;
-	u8 reg;
-
-	*val = 0;
-
-	if (!s_data->group_hold_active) {
-		err = imx900_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: error setting register hold\n",
-								__func__);
-			return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx900_read_reg(s_data, addr_low + i, &reg);
-		*val += reg << (i * 8);
-		if (err) {
-			dev_err(dev, "%s: error reading buffered registers\n",
-								 __func__);
-			return err;
-		}
-	}
-
-	if (!s_data->group_hold_active) {
-		err = imx900_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: error unsetting register hold\n",
-								__func__);
-		return err;
-		}
-	}
-
-	return err;
+	return fr_read_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx900_write_buffered_reg(struct camera_common_data *s_data,
 			u16 addr_low, u8 number_of_registers, u64 val)
 {
-	int err, i;
-	struct device *dev = s_data->dev;
-
-	if (!s_data->group_hold_active) {
-		err = imx900_write_reg(s_data, REGHOLD, 0x01);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD error\n", __func__);
-		return err;
-		}
-	}
-
-	for (i = 0; i < number_of_registers; i++) {
-		err = imx900_write_reg(s_data, addr_low + i,
-							(u8)(val >> (i * 8)));
-		if (err) {
-			dev_err(dev, "%s: BUFFERED register write error\n",
-								__func__);
-			return err;
-		}
-	}
+	struct imx900 *priv = (struct imx900 *)s_data->priv;
 
-	if (!s_data->group_hold_active) {
-		err = imx900_write_reg(s_data, REGHOLD, 0x00);
-		if (err) {
-			dev_err(dev, "%s: GRP_PARAM_HOLD erroror\n", __func__);
-		return err;
-		}
-	}
+	if (priv->ctrl_blob.blob)
+		return fr_blob_buffered_reg(&priv->ctrl_blob, REGHOLD,
+			addr_low, number_of_registers, val, false);
 
-	return err;
+	return fr_write_buffered_reg(s_data, s_data->regmap, REGHOLD,
+			addr_low, number_of_registers, val, false);
 }
 
 static int imx900_write_table(struct imx900 *priv, const imx900_reg table[])
 {
 	struct camera_common_data *s_data = priv->s_data;
 
-	return regmap_util_write_table_8(s_data->regmap,
-					table,
-					NULL, 0,
-					IMX900_TABLE_WAIT_MS,
-					IMX900_TABLE_END);
+	return fr_write_table_cached(s_data->regmap, &priv->table_cache,
+				table, IMX900_TABLE_WAIT_MS, IMX900_TABLE_END,
+				&priv->table_stats);
 }
 
 static int imx900_chromacity_mode(struct tegracam_device *tc_dev)
@@ -705,6 +650,7 @@ static int imx900_power_off(struct camera_common_data *s_data)
 	}
 
 power_off_done:
+	fr_table_cache_invalidate(s_data->regmap, &priv->table_cache);
 	pw->state = SWITCH_OFF;
 	mutex_unlock(&priv->pw_mutex);
 
@@ -964,692 +910,174 @@ static int imx900_set_csi_lane_mode(struct tegracam_device *tc_dev)
 	return 0;
 }
 
-static int imx900_write_mode_dep_chromacity(struct tegracam_device *tc_dev,
-					int table1, int table2, int table3)
+/* Mode classes with their own line timing in the data rate table */
+enum {
+	IMX900_RATE_MODE_SUBSAMPLING2,
+	IMX900_RATE_MODE_BINNING_CROP,
+	IMX900_RATE_MODE_FULL,
+	IMX900_RATE_NUM_MODES,
+};
+
+/* HMAX and dependent register table per [chromacity][mode class] */
+struct imx900_rate_entry {
+	u16 hmax[2][IMX900_RATE_NUM_MODES];
+	u16 dep_table[2][IMX900_RATE_NUM_MODES];
+};
+
+#define IMX900_DEP_TABLE(name, rate, bpp, lanes) \
+	IMX900_##name##_##rate##MBPS_1x##bpp##_##lanes##LANE
+
+#define IMX900_RATE_ENTRY(rate, bpp, lanes, sub2_color, bin_color,	\
+						bin_mono, full)		\
+	[IMX900_##rate##_MBPS][FR_BPP_##bpp][FR_LANES_##lanes] = {	\
+		.hmax = {						\
+			[IMX900_COLOR] = { sub2_color, bin_color, full },	\
+			[IMX900_MONO] = { bin_mono, bin_mono, full },	\
+		},							\
+		.dep_table = {						\
+			[IMX900_COLOR] = {				\
+				IMX900_DEP_TABLE(SUBSAMPLING2_COLOR,	\
+						rate, bpp, lanes),	\
+				IMX900_DEP_TABLE(ALLPIXEL_ROI_SUBSAMPLING10, \
+						rate, bpp, lanes),	\
+				IMX900_DEP_TABLE(ALLPIXEL_ROI_SUBSAMPLING10, \
+						rate, bpp, lanes),	\
+			},						\
+			[IMX900_MONO] = {				\
+				IMX900_DEP_TABLE(SUBSAMPLING2_BINNING_MONO, \
+						rate, bpp, lanes),	\
+				IMX900_DEP_TABLE(SUBSAMPLING2_BINNING_MONO, \
+						rate, bpp, lanes),	\
+				IMX900_DEP_TABLE(ALLPIXEL_ROI_SUBSAMPLING10, \
+						rate, bpp, lanes),	\
+			},						\
+		},							\
+	}
+
+/*
+ * Line timing of each data rate, pixel depth and lane count. HMAX columns
+ * are color subsampling2, color binning crop, mono subsampling2 and
+ * binning crop, and every other mode.
+ */
+static const struct imx900_rate_entry
+imx900_rate_table[IMX900_594_MBPS + 1][FR_NUM_BPP][FR_NUM_LANES] = {
+	IMX900_RATE_ENTRY(2376, 8, 1, 0x152, 0x22A, 0x128, 0x22A),
+	IMX900_RATE_ENTRY(2376, 8, 2, 0x152, 0x152, 0x0A9, 0x152),
+	IMX900_RATE_ENTRY(2376, 8, 4, 0x152, 0x152, 0x0A9, 0x152),
+	IMX900_RATE_ENTRY(2376, 10, 1, 0x16C, 0x2AB, 0x168, 0x2AB),
+	IMX900_RATE_ENTRY(2376, 10, 2, 0x16C, 0x16C, 0x0C7, 0x16C),
+	IMX900_RATE_ENTRY(2376, 10, 4, 0x16C, 0x16C, 0x0B6, 0x16C),
+	IMX900_RATE_ENTRY(2376, 12, 1, 0x262, 0x32C, 0x1A9, 0x32C),
+	IMX900_RATE_ENTRY(2376, 12, 2, 0x262, 0x262, 0x131, 0x262),
+	IMX900_RATE_ENTRY(2376, 12, 4, 0x262, 0x262, 0x131, 0x262),
+	IMX900_RATE_ENTRY(1485, 8, 1, 0x1CC, 0x1CC, 0x1CC, 0x369),
+	IMX900_RATE_ENTRY(1485, 8, 2, 0x152, 0x1CC, 0x0FE, 0x1CC),
+	IMX900_RATE_ENTRY(1485, 8, 4, 0x152, 0x152, 0x0A9, 0x152),
+	IMX900_RATE_ENTRY(1485, 10, 1, 0x234, 0x234, 0x234, 0x438),
+	IMX900_RATE_ENTRY(1485, 10, 2, 0x16C, 0x234, 0x131, 0x234),
+	IMX900_RATE_ENTRY(1485, 10, 4, 0x16C, 0x16C, 0x0B6, 0x16C),
+	IMX900_RATE_ENTRY(1485, 12, 1, 0x29B, 0x29B, 0x29B, 0x506),
+	IMX900_RATE_ENTRY(1485, 12, 2, 0x262, 0x29B, 0x165, 0x29B),
+	IMX900_RATE_ENTRY(1485, 12, 4, 0x262, 0x262, 0x131, 0x262),
+	IMX900_RATE_ENTRY(1188, 8, 1, 0x23B, 0x23B, 0x23B, 0x43F),
+	IMX900_RATE_ENTRY(1188, 8, 2, 0x152, 0x23B, 0x139, 0x23B),
+	IMX900_RATE_ENTRY(1188, 8, 4, 0x152, 0x152, 0x0B8, 0x152),
+	IMX900_RATE_ENTRY(1188, 10, 1, 0x2BC, 0x2BC, 0x2BC, 0x541),
+	IMX900_RATE_ENTRY(1188, 10, 2, 0x179, 0x179, 0x179, 0x2BC),
+	IMX900_RATE_ENTRY(1188, 10, 4, 0x16C, 0x17A, 0x0D8, 0x17A),
+	IMX900_RATE_ENTRY(1188, 12, 1, 0x33D, 0x33D, 0x33D, 0x643),
+	IMX900_RATE_ENTRY(1188, 12, 2, 0x262, 0x33D, 0x1BA, 0x33D),
+	IMX900_RATE_ENTRY(1188, 12, 4, 0x262, 0x262, 0x131, 0x262),
+	IMX900_RATE_ENTRY(891, 8, 1, 0x2F4, 0x2F4, 0x2F4, 0x5A4),
+	IMX900_RATE_ENTRY(891, 8, 2, 0x19C, 0x19C, 0x19C, 0x2F4),
+	IMX900_RATE_ENTRY(891, 8, 4, 0x152, 0x19C, 0x0F0, 0x19C),
+	IMX900_RATE_ENTRY(891, 10, 1, 0x3A0, 0x3A0, 0x3A0, 0x6FC),
+	IMX900_RATE_ENTRY(891, 10, 2, 0x1F2, 0x1F2, 0x1F2, 0x3A0),
+	IMX900_RATE_ENTRY(891, 10, 4, 0x16C, 0x1F3, 0x11B, 0x1F3),
+	IMX900_RATE_ENTRY(891, 12, 1, 0x44C, 0x44C, 0x44C, 0x854),
+	IMX900_RATE_ENTRY(891, 12, 2, 0x262, 0x44C, 0x248, 0x44C),
+	IMX900_RATE_ENTRY(891, 12, 4, 0x262, 0x262, 0x147, 0x262),
+	IMX900_RATE_ENTRY(594, 8, 1, 0x45E, 0x45E, 0x45E, 0x866),
+	IMX900_RATE_ENTRY(594, 8, 2, 0x258, 0x258, 0x258, 0x45C),
+	IMX900_RATE_ENTRY(594, 8, 4, 0x158, 0x158, 0x158, 0x25A),
+	IMX900_RATE_ENTRY(594, 10, 1, 0x560, 0x560, 0x560, 0xA6A),
+	IMX900_RATE_ENTRY(594, 10, 2, 0x2DA, 0x2DA, 0x2DA, 0x55E),
+	IMX900_RATE_ENTRY(594, 10, 4, 0x198, 0x198, 0x198, 0x2DA),
+	IMX900_RATE_ENTRY(594, 12, 1, 0x662, 0x662, 0x662, 0xC6E),
+	IMX900_RATE_ENTRY(594, 12, 2, 0x35A, 0x35A, 0x35A, 0x660),
+	IMX900_RATE_ENTRY(594, 12, 4, 0x262, 0x35C, 0x1D8, 0x35C),
+};
+
+static const struct imx900_rate_entry *imx900_lookup_rate_entry(
+					const struct fr_rate_key *key)
+{
+	const struct imx900_rate_entry *entry;
+
+	entry = &imx900_rate_table[key->rate][key->bpp][key->lanes];
+
+	return entry->hmax[IMX900_COLOR][IMX900_RATE_MODE_FULL] ? entry : NULL;
+}
+
+static const struct imx900_rate_entry *imx900_get_rate_entry(
+					struct tegracam_device *tc_dev)
 {
-	struct imx900 *priv = (struct imx900 *)tc_dev->priv;
-	struct camera_common_data *s_data = tc_dev->s_data;
-	int err = 0;
+	const struct imx900_rate_entry *entry;
+	struct device *dev = tc_dev->dev;
+	struct fr_rate_key key;
+	int err;
 
-	if (priv->chromacity == IMX900_COLOR) {
-		if (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776)
-			err = imx900_write_table(priv, mode_table[table1]);
-		else
-			err = imx900_write_table(priv, mode_table[table2]);
-	} else {
-		if ((s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ||
-			(s_data->mode == IMX900_MODE_BINNING_CROP_1024x720))
-			err = imx900_write_table(priv, mode_table[table3]);
-		else
-			err = imx900_write_table(priv, mode_table[table2]);
+	err = fr_rate_key_get(tc_dev, ARRAY_SIZE(imx900_rate_table), &key);
+	if (err == -ERANGE)
+		/* Adjustment isn't needed */
+		return NULL;
+
+	if (!err) {
+		entry = imx900_lookup_rate_entry(&key);
+		if (entry)
+			return entry;
 	}
 
-	return err;
+	dev_err(dev, "%s: unknown pixel format or lane mode\n", __func__);
+	return NULL;
+}
+
+static inline int imx900_rate_chromacity(struct imx900 *priv)
+{
+	return (priv->chromacity == IMX900_COLOR) ? IMX900_COLOR : IMX900_MONO;
+}
+
+static inline int imx900_rate_mode(u32 mode)
+{
+	switch (mode) {
+	case IMX900_MODE_SUBSAMPLING2_1032x776:
+		return IMX900_RATE_MODE_SUBSAMPLING2;
+	case IMX900_MODE_BINNING_CROP_1024x720:
+		return IMX900_RATE_MODE_BINNING_CROP;
+	default:
+		return IMX900_RATE_MODE_FULL;
+	}
 }
 
 static int imx900_set_dep_registers(struct tegracam_device *tc_dev)
 {
-	struct device *dev = tc_dev->dev;
+	struct imx900 *priv = (struct imx900 *)tc_dev->priv;
 	struct camera_common_data *s_data = tc_dev->s_data;
+	struct device *dev = tc_dev->dev;
+	const struct imx900_rate_entry *entry;
 	int err;
 
-	switch (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_DATA_RATE, CURRENT)) {
-	case IMX900_2376_MBPS:
-		switch (s_data->colorfmt->code) {
-		case MEDIA_BUS_FMT_SRGGB8_1X8:
-		case MEDIA_BUS_FMT_SGBRG8_1X8:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x8_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x8_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x8_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x8_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x8_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x8_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-				return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x8_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x8_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x8_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-					}
-				break;
-			default:
-					dev_err(dev, "%s: unknown lane mode\n", __func__);
-					return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB10_1X10:
-		case MEDIA_BUS_FMT_SGBRG10_1X10:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x10_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x10_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x10_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x10_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x10_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x10_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x10_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x10_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x10_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB12_1X12:
-		case MEDIA_BUS_FMT_SGBRG12_1X12:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x12_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x12_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x12_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-				return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x12_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x12_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x12_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x12_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x12_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x12_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-				return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		default:
-			dev_err(dev, "%s: unknown pixel format\n", __func__);
-			return 0;
-		}
-		break;
-	case IMX900_1485_MBPS:
-		switch (s_data->colorfmt->code) {
-		case MEDIA_BUS_FMT_SRGGB8_1X8:
-		case MEDIA_BUS_FMT_SGBRG8_1X8:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x8_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x8_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x8_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x8_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x8_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x8_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x8_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x8_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x8_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB10_1X10:
-		case MEDIA_BUS_FMT_SGBRG10_1X10:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x10_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x10_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x10_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x10_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x10_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x10_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x10_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x10_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x10_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB12_1X12:
-		case MEDIA_BUS_FMT_SGBRG12_1X12:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x12_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x12_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x12_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x12_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x12_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x12_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x12_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x12_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x12_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		default:
-			dev_err(dev, "%s: unknown pixel format\n", __func__);
-			return 0;
-		}
-		break;
-	case IMX900_1188_MBPS:
-		switch (s_data->colorfmt->code) {
-		case MEDIA_BUS_FMT_SRGGB8_1X8:
-		case MEDIA_BUS_FMT_SGBRG8_1X8:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x8_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x8_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x8_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x8_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x8_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x8_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x8_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x8_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x8_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB10_1X10:
-		case MEDIA_BUS_FMT_SGBRG10_1X10:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x10_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x10_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x10_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x10_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x10_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x10_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x10_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x10_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x10_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB12_1X12:
-		case MEDIA_BUS_FMT_SGBRG12_1X12:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x12_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x12_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x12_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x12_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x12_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x12_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x12_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x12_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x12_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		default:
-			dev_err(dev, "%s: unknown pixel format\n", __func__);
-		return 0;
-		}
-		break;
-	case IMX900_891_MBPS:
-		switch (s_data->colorfmt->code) {
-		case MEDIA_BUS_FMT_SRGGB8_1X8:
-		case MEDIA_BUS_FMT_SGBRG8_1X8:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x8_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x8_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x8_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x8_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x8_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x8_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-				return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x8_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x8_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x8_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB10_1X10:
-		case MEDIA_BUS_FMT_SGBRG10_1X10:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x10_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x10_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x10_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x10_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x10_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x10_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x10_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x10_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x10_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB12_1X12:
-		case MEDIA_BUS_FMT_SGBRG12_1X12:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x12_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x12_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x12_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x12_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x12_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x12_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x12_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x12_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x12_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		default:
-			dev_err(dev, "%s: unknown pixel format\n", __func__);
-			return 0;
-		}
-		break;
-	case IMX900_594_MBPS:
-		switch (s_data->colorfmt->code) {
-		case MEDIA_BUS_FMT_SRGGB8_1X8:
-		case MEDIA_BUS_FMT_SGBRG8_1X8:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x8_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x8_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x8_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x8_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x8_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x8_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x8_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x8_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x8_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB10_1X10:
-		case MEDIA_BUS_FMT_SGBRG10_1X10:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x10_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x10_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x10_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x10_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x10_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x10_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x10_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x10_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x10_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB12_1X12:
-		case MEDIA_BUS_FMT_SGBRG12_1X12:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x12_1LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x12_1LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x12_1LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_TWO_LANE_MODE:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x12_2LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x12_2LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x12_2LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			case IMX900_MAX_CSI_LANES:
-				err = imx900_write_mode_dep_chromacity(tc_dev,
-					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x12_4LANE,
-					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x12_4LANE,
-					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x12_4LANE);
-				if (err) {
-					dev_err(dev, "%s: error setting dep register table\n",
-										__func__);
-					return err;
-				}
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		default:
-			dev_err(dev, "%s: unknown pixel format\n", __func__);
-			return 0;
-		}
-		break;
-	default:
-		/* Adjusment isn't needed */
+	entry = imx900_get_rate_entry(tc_dev);
+	if (!entry)
 		return 0;
+
+	err = imx900_write_table(priv, mode_table[entry->dep_table
+		[imx900_rate_chromacity(priv)][imx900_rate_mode(s_data->mode)]]);
+	if (err) {
+		dev_err(dev, "%s: error setting dep register table\n", __func__);
+		return err;
 	}
 
-	return err;
+	return 0;
 }
 
 static int imx900_calculate_line_time(struct tegracam_device *tc_dev)
@@ -1682,426 +1110,18 @@ static int imx900_adjust_hmax_register(struct tegracam_device *tc_dev)
 	struct camera_common_data *s_data = tc_dev->s_data;
 	struct imx900 *priv = (struct imx900 *)tc_dev->priv;
 	struct device *dev = tc_dev->dev;
+	const struct imx900_rate_entry *entry;
 	int err;
 	u64 hmax;
 
 	dev_dbg(dev, "%s:++\n", __func__);
 
-	switch (fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_DATA_RATE, CURRENT)) {
-	case IMX900_2376_MBPS:
-		switch (s_data->colorfmt->code) {
-		case MEDIA_BUS_FMT_SRGGB8_1X8:
-		case MEDIA_BUS_FMT_SGBRG8_1X8:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0X152 : 0x22A;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x128 : 0x22A;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = 0x152;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0A9 : 0x152;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = 0x152;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0A9 : 0x152;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB10_1X10:
-		case MEDIA_BUS_FMT_SGBRG10_1X10:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x16C : 0x2AB;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x168 : 0x2AB;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = 0x16C;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0C7 : 0x16C;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = 0x16C;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0B6 : 0x16C;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB12_1X12:
-		case MEDIA_BUS_FMT_SGBRG12_1X12:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x262 : 0x32C;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x1A9 : 0x32C;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = 0x262;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x131 : 0x262;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = 0x262;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x131 : 0x262;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		default:
-			dev_err(dev, "%s: unknown pixel format\n", __func__);
-			return 0;
-		}
-		break;
-	case IMX900_1485_MBPS:
-		switch (s_data->colorfmt->code) {
-		case MEDIA_BUS_FMT_SRGGB8_1X8:
-		case MEDIA_BUS_FMT_SGBRG8_1X8:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x1CC : 0x369;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x152 : 0x1CC;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0FE : 0x1CC;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = 0x152;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0A9 : 0x152;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB10_1X10:
-		case MEDIA_BUS_FMT_SGBRG10_1X10:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x234 : 0x438;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x16C : 0x234;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x131 : 0x234;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = 0x16C;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0B6 : 0x16C;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB12_1X12:
-		case MEDIA_BUS_FMT_SGBRG12_1X12:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x29B : 0x506;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x262 : 0x29B;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x165 : 0x29B;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = 0x262;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x131 : 0x262;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		default:
-			dev_err(dev, "%s: unknown pixel format\n", __func__);
-			return 0;
-		}
-		break;
-	case IMX900_1188_MBPS:
-		switch (s_data->colorfmt->code) {
-		case MEDIA_BUS_FMT_SRGGB8_1X8:
-		case MEDIA_BUS_FMT_SGBRG8_1X8:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x23B : 0x43F;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x152 : 0x23B;
-				else
-					hmax = ((s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ||
-						(s_data->mode == IMX900_MODE_BINNING_CROP_1024x720)) ? 0x139 : 0x23B;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = 0x152;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0B8 : 0x152;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB10_1X10:
-		case MEDIA_BUS_FMT_SGBRG10_1X10:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x2BC : 0x541;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x179 : 0x2BC;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x16C : 0x17A;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0D8 : 0x17A;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-		break;
-		case MEDIA_BUS_FMT_SRGGB12_1X12:
-		case MEDIA_BUS_FMT_SGBRG12_1X12:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x33D : 0x643;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x262 : 0x33D;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x1BA : 0x33D;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = 0x262;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x131 : 0x262;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		default:
-			dev_err(dev, "%s: unknown pixel format\n", __func__);
-			return 0;
-		}
-		break;
-	case IMX900_891_MBPS:
-		switch (s_data->colorfmt->code) {
-		case MEDIA_BUS_FMT_SRGGB8_1X8:
-		case MEDIA_BUS_FMT_SGBRG8_1X8:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x2F4 : 0x5A4;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x19C : 0x2F4;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x152 : 0x19C;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0F0 : 0x19C;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB10_1X10:
-		case MEDIA_BUS_FMT_SGBRG10_1X10:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x3A0 : 0x6FC;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x1F2 : 0x3A0;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x16C : 0x1F3;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x11B : 0x1F3;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB12_1X12:
-		case MEDIA_BUS_FMT_SGBRG12_1X12:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x44C : 0x854;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x262 : 0x44C;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x248 : 0x44C;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = 0x262;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x147 : 0x262;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		default:
-			dev_err(dev, "%s: unknown pixel format\n", __func__);
-			return 0;
-		}
-		break;
-	case IMX900_594_MBPS:
-		switch (s_data->colorfmt->code) {
-		case MEDIA_BUS_FMT_SRGGB8_1X8:
-		case MEDIA_BUS_FMT_SGBRG8_1X8:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x45E : 0x866;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x258 : 0x45C;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x158 : 0x25A;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB10_1X10:
-		case MEDIA_BUS_FMT_SGBRG10_1X10:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x560 : 0xA6A;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x2DA : 0x55E;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x198 : 0x2DA;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		case MEDIA_BUS_FMT_SRGGB12_1X12:
-		case MEDIA_BUS_FMT_SGBRG12_1X12:
-			switch (s_data->numlanes) {
-			case IMX900_ONE_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x662 : 0xC6E;
-				break;
-			case IMX900_TWO_LANE_MODE:
-				hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-					s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x35A : 0x660;
-				break;
-			case IMX900_MAX_CSI_LANES:
-				if (priv->chromacity == IMX900_COLOR)
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x262 : 0x35C;
-				else
-					hmax = (s_data->mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
-						s_data->mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x1D8 : 0x35C;
-				break;
-			default:
-				dev_err(dev, "%s: unknown lane mode\n", __func__);
-				return 0;
-			}
-			break;
-		default:
-			dev_err(dev, "%s: unknown pixel format\n", __func__);
-			return 0;
-		}
-		break;
-	default:
-		/* Adjusment isn't needed */
+	entry = imx900_get_rate_entry(tc_dev);
+	if (!entry)
 		return 0;
-	}
+
+	hmax = entry->hmax[imx900_rate_chromacity(priv)]
+				[imx900_rate_mode(s_data->mode)];
 
 	err = imx900_write_buffered_reg(s_data, HMAX_LOW, 2, hmax);
 	if (err) {
@@ -2464,8 +1484,14 @@ static int imx900_set_mode(struct tegracam_device *tc_dev)
 	struct imx900 *priv = (struct imx900 *)tegracam_get_privdata(tc_dev);
 	struct camera_common_data *s_data = tc_dev->s_data;
 	struct device *dev = tc_dev->dev;
+	struct fr_ctrl_snapshot ctrls;
 	int err;
 
+	fr_table_stats_begin(&priv->table_stats);
+	fr_stream_settle(&priv->stream_stop);
+	fr_table_cache_begin_mode(&priv->table_cache);
+	fr_ctrl_snapshot_take(tc_dev, &ctrls);
+
 	err = imx900_chromacity_mode(tc_dev);
 	if (err) {
 		dev_err(dev, "%s: unable to get chromacity information\n",
@@ -2507,8 +1533,7 @@ static int imx900_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx900_set_operation_mode(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-				TEGRA_CAMERA_CID_OPERATION_MODE, CURRENT));
+	err = imx900_set_operation_mode(tc_dev, ctrls.operation_mode);
 	if (err) {
 		dev_err(dev, "%s: unable to set operation mode\n", __func__);
 		return err;
@@ -2534,8 +1559,7 @@ static int imx900_set_mode(struct tegracam_device *tc_dev)
 		return err;
 	}
 
-	err = imx900_set_test_pattern(tc_dev, fr_get_v4l2_ctrl_value(tc_dev,
-				TEGRA_CAMERA_CID_TEST_PATTERN, CURRENT));
+	err = imx900_set_test_pattern(tc_dev, ctrls.test_pattern);
 	if (err) {
 		dev_err(dev, "%s: unable to set Test pattern\n", __func__);
 		return err;
@@ -2562,6 +1586,8 @@ static int imx900_set_mode(struct tegracam_device *tc_dev)
 	if (err)
 		goto fail;
 
+	fr_table_cache_end_mode(&priv->table_cache);
+	fr_table_stats_end(dev, &priv->table_stats, s_data->mode);
 	dev_dbg(dev, "%s: set mode %u\n", __func__, s_data->mode);
 
 	return 0;
@@ -2621,6 +1647,8 @@ static int imx900_stop_streaming(struct tegracam_device *tc_dev)
 	struct device *dev = tc_dev->dev;
 	int err;
 
+	fr_stream_stop_begin(&priv->stream_stop);
+
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
 		max96792_stop_streaming(priv->s_data->dser_dev, dev);
 
@@ -2628,8 +1656,8 @@ static int imx900_stop_streaming(struct tegracam_device *tc_dev)
 	if (err)
 		return err;
 
-	usleep_range(priv->frame_length * priv->line_time / IMX900_K_FACTOR,
-		priv->frame_length * priv->line_time / IMX900_K_FACTOR + 1000);
+	fr_stream_stop_end(&priv->stream_stop,
+		priv->frame_length * priv->line_time / IMX900_K_FACTOR);
 
 	return 0;
 }
@@ -2664,7 +1692,7 @@ static int imx900_gmsl_serdes_setup(struct imx900 *priv)
 	dev = &priv->i2c_client->dev;
 
 	dev_dbg(dev, "%s: IMX900_gmsl_serdes_setup\n", __func__);
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
@@ -2712,20 +1740,20 @@ static int imx900_gmsl_serdes_setup(struct imx900 *priv)
 	}
 
 error:
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 	return err;
 }
 
 static void imx900_gmsl_serdes_reset(struct imx900 *priv)
 {
-	mutex_lock(&serdes_lock__);
+	max96792_serdes_lock(priv->s_data->dser_dev);
 
 	max96793_reset_control(priv->s_data->ser_dev);
 	max96792_reset_control(priv->s_data->dser_dev, &priv->i2c_client->dev);
 
 	max96792_power_off(priv->s_data->dser_dev, &priv->s_data->g_ctx);
 
-	mutex_unlock(&serdes_lock__);
+	max96792_serdes_unlock(priv->s_data->dser_dev);
 }
 
 static int imx900_board_setup(struct imx900 *priv)
@@ -2902,7 +1930,6 @@ static int imx900_board_setup(struct imx900 *priv)
 
 		priv->s_data->g_ctx.s_dev = dev;
 
-		mutex_init(&serdes_lock__);
 		err = max96793_sdev_pair(priv->s_data->ser_dev,
 							&priv->s_data->g_ctx);
 		if (err) {
@@ -2971,13 +1998,52 @@ static const struct v4l2_subdev_internal_ops imx900_subdev_internal_ops = {
 	.open = imx900_open,
 };
 
-static struct tegracam_ctrl_ops imx900_ctrl_ops = {
+static int imx900_set_group_hold_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, bool val)
+{
+	struct imx900 *priv = (struct imx900 *)tc_dev->priv;
+
+	return fr_set_group_hold_ex(&priv->ctrl_blob, blob, REGHOLD, val);
+}
+
+static int imx900_set_gain_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx900 *priv = (struct imx900 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx900_set_gain, val);
+}
+
+static int imx900_set_exposure_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx900 *priv = (struct imx900 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx900_set_exposure, val);
+}
+
+static int imx900_set_frame_rate_ex(struct tegracam_device *tc_dev,
+			struct sensor_blob *blob, s64 val)
+{
+	struct imx900 *priv = (struct imx900 *)tc_dev->priv;
+
+	return fr_set_ctrl_ex(tc_dev, &priv->ctrl_blob, blob,
+					imx900_set_frame_rate, val);
+}
+
+static const struct tegracam_ctrl_ops imx900_ctrl_ops = {
 	.numctrls = ARRAY_SIZE(ctrl_cid_list),
 	.ctrl_cid_list = ctrl_cid_list,
 	.set_gain = imx900_set_gain,
 	.set_exposure = imx900_set_exposure,
 	.set_frame_rate = imx900_set_frame_rate,
 	.set_group_hold = imx900_set_group_hold,
+	.set_gain_ex = imx900_set_gain_ex,
+	.set_exposure_ex = imx900_set_exposure_ex,
+	.set_frame_rate_ex = imx900_set_frame_rate_ex,
+	.set_group_hold_ex = imx900_set_group_hold_ex,
 	.set_test_pattern = imx900_set_test_pattern,
 	.set_data_rate = imx900_set_data_rate,
 	.set_operation_mode = imx900_set_operation_mode,
@@ -3020,7 +2086,8 @@ static int imx900_probe(struct i2c_client *client,
 	tc_dev->dev_regmap_config = &sensor_regmap_config;
 	tc_dev->sensor_ops = &imx900_common_ops;
 	tc_dev->v4l2sd_internal_ops = &imx900_subdev_internal_ops;
-	tc_dev->tcctrl_ops = &imx900_ctrl_ops;
+	fr_select_ctrl_ops(&priv->ctrl_ops, &imx900_ctrl_ops);
+	tc_dev->tcctrl_ops = &priv->ctrl_ops;
 
 	err = tegracam_device_register(tc_dev);
 	if (err) {
@@ -3032,6 +2099,17 @@ static int imx900_probe(struct i2c_client *client,
 	priv->subdev = &tc_dev->s_data->subdev;
 	tegracam_set_privdata(tc_dev, (void *)priv);
 
+	err = fr_table_cache_add(dev, &priv->table_cache, mode_table,
+			ARRAY_SIZE(mode_table), IMX900_TABLE_WAIT_MS, IMX900_TABLE_END);
+	if (!err)
+		err = fr_table_cache_add(dev, &priv->table_cache,
+			data_rate_table, ARRAY_SIZE(data_rate_table),
+			IMX900_TABLE_WAIT_MS, IMX900_TABLE_END);
+	if (err) {
+		dev_err(dev, "unable to compile mode tables\n");
+		return err;
+	}
+
 	priv->frame_length = IMX900_DEFAULT_HEIGHT + IMX900_MIN_FRAME_DELTA;
 	priv->current_pixel_format = MEDIA_BUS_FMT_SGBRG12_1X12;
 	priv->line_time = IMX900_DEFAULT_LINE_TIME;
@@ -3074,7 +2152,11 @@ static int imx900_probe(struct i2c_client *client,
 	if (err)
 		return err;
 
+	mutex_lock(&imx900_sensor_list_lock);
 	list_add_tail(&priv->entry, &imx900_sensor_list);
+	mutex_unlock(&imx900_sensor_list_lock);
+
+	fr_stop_debugfs_init(dev, &priv->stream_stop);
 
 	dev_info(dev, "Detected imx900 sensor\n");
 
@@ -3104,12 +2186,10 @@ static void imx900_remove(struct i2c_client *client)
 	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
 		imx900_gmsl_serdes_reset(priv);
 
+	fr_stop_debugfs_remove(&priv->stream_stop);
 	tegracam_v4l2subdev_unregister(priv->tc_dev);
 	tegracam_device_unregister(priv->tc_dev);
 
-	if (!(strcmp(s_data->pdata->gmsl, "gmsl")))
-		mutex_destroy(&serdes_lock__);
-
 #if defined(NV_I2C_DRIVER_STRUCT_REMOVE_RETURN_TYPE_INT) /* Linux 6.1 */
 	return 0;
 #endif
@@ -3127,6 +2207,7 @@ static struct i2c_driver imx900_i2c_driver = {
 		.name = "imx900",
 		.owner = THIS_MODULE,
 		.of_match_table = of_match_ptr(imx900_of_match),
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 	},
 	.probe = imx900_probe,
 	.remove = imx900_remove,
@@ -3138,3 +2219,7 @@ module_i2c_driver(imx900_i2c_driver);
 MODULE_DESCRIPTION("Media Controller driver for Sony IMX900");
 MODULE_AUTHOR("FRAMOS GmbH");
 MODULE_LICENSE("GPL v2");
+
+#if IS_ENABLED(CONFIG_FR_SENSOR_KUNIT_TEST)
+#include "fr_imx900_kunit.c"
+#endif
@@ -0,0 +1,888 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright (c) 2024 Framos. All rights reserved.
+ *
+ * fr_imx900_kunit.c - KUnit tests of the fr_imx900 data rate table
+ *
+ * Included by fr_imx900.c to reach its static tables.
+ */
+
+#include <kunit/test.h>
+
+/*
+ * HMAX and dependent register selection of the driver before the data
+ * rate table was introduced. Kept as the reference every table entry is
+ * checked against. -ERANGE means no adjustment for the data rate and
+ * -EINVAL an unknown pixel format or lane mode.
+ */
+static int imx900_ref_hmax(s64 rate, u32 code, u32 numlanes,
+					u8 chromacity, u32 mode)
+{
+	int hmax;
+
+	switch (rate) {
+	case IMX900_2376_MBPS:
+		switch (code) {
+		case MEDIA_BUS_FMT_SRGGB8_1X8:
+		case MEDIA_BUS_FMT_SGBRG8_1X8:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				if (chromacity == IMX900_COLOR)
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0X152 : 0x22A;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x128 : 0x22A;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				if (chromacity == IMX900_COLOR)
+					hmax = 0x152;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0A9 : 0x152;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				if (chromacity == IMX900_COLOR)
+					hmax = 0x152;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0A9 : 0x152;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB10_1X10:
+		case MEDIA_BUS_FMT_SGBRG10_1X10:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				if (chromacity == IMX900_COLOR)
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x16C : 0x2AB;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x168 : 0x2AB;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				if (chromacity == IMX900_COLOR)
+					hmax = 0x16C;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0C7 : 0x16C;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				if (chromacity == IMX900_COLOR)
+					hmax = 0x16C;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0B6 : 0x16C;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB12_1X12:
+		case MEDIA_BUS_FMT_SGBRG12_1X12:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				if (chromacity == IMX900_COLOR)
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x262 : 0x32C;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x1A9 : 0x32C;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				if (chromacity == IMX900_COLOR)
+					hmax = 0x262;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x131 : 0x262;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				if (chromacity == IMX900_COLOR)
+					hmax = 0x262;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x131 : 0x262;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		default:
+			return -EINVAL;
+		}
+		break;
+	case IMX900_1485_MBPS:
+		switch (code) {
+		case MEDIA_BUS_FMT_SRGGB8_1X8:
+		case MEDIA_BUS_FMT_SGBRG8_1X8:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x1CC : 0x369;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				if (chromacity == IMX900_COLOR)
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x152 : 0x1CC;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0FE : 0x1CC;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				if (chromacity == IMX900_COLOR)
+					hmax = 0x152;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0A9 : 0x152;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB10_1X10:
+		case MEDIA_BUS_FMT_SGBRG10_1X10:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x234 : 0x438;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				if (chromacity == IMX900_COLOR)
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x16C : 0x234;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x131 : 0x234;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				if (chromacity == IMX900_COLOR)
+					hmax = 0x16C;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0B6 : 0x16C;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB12_1X12:
+		case MEDIA_BUS_FMT_SGBRG12_1X12:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x29B : 0x506;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				if (chromacity == IMX900_COLOR)
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x262 : 0x29B;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x165 : 0x29B;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				if (chromacity == IMX900_COLOR)
+					hmax = 0x262;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x131 : 0x262;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		default:
+			return -EINVAL;
+		}
+		break;
+	case IMX900_1188_MBPS:
+		switch (code) {
+		case MEDIA_BUS_FMT_SRGGB8_1X8:
+		case MEDIA_BUS_FMT_SGBRG8_1X8:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x23B : 0x43F;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				if (chromacity == IMX900_COLOR)
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x152 : 0x23B;
+				else
+					hmax = ((mode == IMX900_MODE_SUBSAMPLING2_1032x776) ||
+						(mode == IMX900_MODE_BINNING_CROP_1024x720)) ? 0x139 : 0x23B;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				if (chromacity == IMX900_COLOR)
+					hmax = 0x152;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0B8 : 0x152;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB10_1X10:
+		case MEDIA_BUS_FMT_SGBRG10_1X10:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x2BC : 0x541;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x179 : 0x2BC;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				if (chromacity == IMX900_COLOR)
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x16C : 0x17A;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0D8 : 0x17A;
+				break;
+			default:
+				return -EINVAL;
+			}
+		break;
+		case MEDIA_BUS_FMT_SRGGB12_1X12:
+		case MEDIA_BUS_FMT_SGBRG12_1X12:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x33D : 0x643;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				if (chromacity == IMX900_COLOR)
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x262 : 0x33D;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x1BA : 0x33D;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				if (chromacity == IMX900_COLOR)
+					hmax = 0x262;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x131 : 0x262;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		default:
+			return -EINVAL;
+		}
+		break;
+	case IMX900_891_MBPS:
+		switch (code) {
+		case MEDIA_BUS_FMT_SRGGB8_1X8:
+		case MEDIA_BUS_FMT_SGBRG8_1X8:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x2F4 : 0x5A4;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x19C : 0x2F4;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				if (chromacity == IMX900_COLOR)
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x152 : 0x19C;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x0F0 : 0x19C;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB10_1X10:
+		case MEDIA_BUS_FMT_SGBRG10_1X10:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x3A0 : 0x6FC;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x1F2 : 0x3A0;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				if (chromacity == IMX900_COLOR)
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x16C : 0x1F3;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x11B : 0x1F3;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB12_1X12:
+		case MEDIA_BUS_FMT_SGBRG12_1X12:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x44C : 0x854;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				if (chromacity == IMX900_COLOR)
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x262 : 0x44C;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x248 : 0x44C;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				if (chromacity == IMX900_COLOR)
+					hmax = 0x262;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x147 : 0x262;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		default:
+			return -EINVAL;
+		}
+		break;
+	case IMX900_594_MBPS:
+		switch (code) {
+		case MEDIA_BUS_FMT_SRGGB8_1X8:
+		case MEDIA_BUS_FMT_SGBRG8_1X8:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x45E : 0x866;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x258 : 0x45C;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x158 : 0x25A;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB10_1X10:
+		case MEDIA_BUS_FMT_SGBRG10_1X10:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x560 : 0xA6A;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x2DA : 0x55E;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x198 : 0x2DA;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB12_1X12:
+		case MEDIA_BUS_FMT_SGBRG12_1X12:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x662 : 0xC6E;
+				break;
+			case IMX900_TWO_LANE_MODE:
+				hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+					mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x35A : 0x660;
+				break;
+			case IMX900_MAX_CSI_LANES:
+				if (chromacity == IMX900_COLOR)
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776) ? 0x262 : 0x35C;
+				else
+					hmax = (mode == IMX900_MODE_SUBSAMPLING2_1032x776 ||
+						mode == IMX900_MODE_BINNING_CROP_1024x720) ? 0x1D8 : 0x35C;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		default:
+			return -EINVAL;
+		}
+		break;
+	default:
+		return -ERANGE;
+	}
+
+	return hmax;
+}
+
+static int imx900_ref_dep_table(u8 chromacity, u32 mode,
+					int table1, int table2, int table3)
+{
+	if (chromacity == IMX900_COLOR) {
+		if (mode == IMX900_MODE_SUBSAMPLING2_1032x776)
+			return table1;
+		else
+			return table2;
+	} else {
+		if ((mode == IMX900_MODE_SUBSAMPLING2_1032x776) ||
+			(mode == IMX900_MODE_BINNING_CROP_1024x720))
+			return table3;
+		else
+			return table2;
+	}
+}
+
+static int imx900_ref_dep(s64 rate, u32 code, u32 numlanes,
+					u8 chromacity, u32 mode)
+{
+	switch (rate) {
+	case IMX900_2376_MBPS:
+		switch (code) {
+		case MEDIA_BUS_FMT_SRGGB8_1X8:
+		case MEDIA_BUS_FMT_SGBRG8_1X8:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x8_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x8_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x8_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x8_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x8_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x8_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x8_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x8_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x8_4LANE);
+			default:
+					return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB10_1X10:
+		case MEDIA_BUS_FMT_SGBRG10_1X10:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x10_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x10_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x10_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x10_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x10_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x10_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x10_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x10_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x10_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB12_1X12:
+		case MEDIA_BUS_FMT_SGBRG12_1X12:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x12_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x12_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x12_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x12_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x12_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x12_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_2376MBPS_1x12_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_2376MBPS_1x12_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_2376MBPS_1x12_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		default:
+			return -EINVAL;
+		}
+		break;
+	case IMX900_1485_MBPS:
+		switch (code) {
+		case MEDIA_BUS_FMT_SRGGB8_1X8:
+		case MEDIA_BUS_FMT_SGBRG8_1X8:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x8_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x8_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x8_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x8_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x8_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x8_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x8_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x8_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x8_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB10_1X10:
+		case MEDIA_BUS_FMT_SGBRG10_1X10:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x10_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x10_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x10_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x10_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x10_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x10_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x10_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x10_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x10_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB12_1X12:
+		case MEDIA_BUS_FMT_SGBRG12_1X12:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x12_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x12_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x12_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x12_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x12_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x12_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1485MBPS_1x12_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1485MBPS_1x12_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1485MBPS_1x12_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		default:
+			return -EINVAL;
+		}
+		break;
+	case IMX900_1188_MBPS:
+		switch (code) {
+		case MEDIA_BUS_FMT_SRGGB8_1X8:
+		case MEDIA_BUS_FMT_SGBRG8_1X8:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x8_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x8_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x8_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x8_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x8_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x8_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x8_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x8_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x8_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB10_1X10:
+		case MEDIA_BUS_FMT_SGBRG10_1X10:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x10_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x10_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x10_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x10_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x10_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x10_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x10_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x10_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x10_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB12_1X12:
+		case MEDIA_BUS_FMT_SGBRG12_1X12:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x12_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x12_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x12_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x12_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x12_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x12_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_1188MBPS_1x12_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_1188MBPS_1x12_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_1188MBPS_1x12_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		default:
+		return -EINVAL;
+		}
+		break;
+	case IMX900_891_MBPS:
+		switch (code) {
+		case MEDIA_BUS_FMT_SRGGB8_1X8:
+		case MEDIA_BUS_FMT_SGBRG8_1X8:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x8_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x8_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x8_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x8_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x8_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x8_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x8_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x8_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x8_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB10_1X10:
+		case MEDIA_BUS_FMT_SGBRG10_1X10:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x10_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x10_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x10_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x10_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x10_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x10_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x10_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x10_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x10_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB12_1X12:
+		case MEDIA_BUS_FMT_SGBRG12_1X12:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x12_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x12_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x12_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x12_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x12_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x12_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_891MBPS_1x12_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_891MBPS_1x12_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_891MBPS_1x12_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		default:
+			return -EINVAL;
+		}
+		break;
+	case IMX900_594_MBPS:
+		switch (code) {
+		case MEDIA_BUS_FMT_SRGGB8_1X8:
+		case MEDIA_BUS_FMT_SGBRG8_1X8:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x8_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x8_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x8_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x8_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x8_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x8_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x8_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x8_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x8_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB10_1X10:
+		case MEDIA_BUS_FMT_SGBRG10_1X10:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x10_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x10_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x10_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x10_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x10_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x10_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x10_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x10_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x10_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		case MEDIA_BUS_FMT_SRGGB12_1X12:
+		case MEDIA_BUS_FMT_SGBRG12_1X12:
+			switch (numlanes) {
+			case IMX900_ONE_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x12_1LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x12_1LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x12_1LANE);
+			case IMX900_TWO_LANE_MODE:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x12_2LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x12_2LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x12_2LANE);
+			case IMX900_MAX_CSI_LANES:
+				return imx900_ref_dep_table(chromacity, mode,
+					IMX900_SUBSAMPLING2_COLOR_594MBPS_1x12_4LANE,
+					IMX900_ALLPIXEL_ROI_SUBSAMPLING10_594MBPS_1x12_4LANE,
+					IMX900_SUBSAMPLING2_BINNING_MONO_594MBPS_1x12_4LANE);
+			default:
+				return -EINVAL;
+			}
+			break;
+		default:
+			return -EINVAL;
+		}
+		break;
+	default:
+		return -ERANGE;
+	}
+
+	return -EINVAL;
+}
+
+static const u32 imx900_test_codes[] = {
+	MEDIA_BUS_FMT_SRGGB8_1X8,
+	MEDIA_BUS_FMT_SGBRG8_1X8,
+	MEDIA_BUS_FMT_SRGGB10_1X10,
+	MEDIA_BUS_FMT_SGBRG10_1X10,
+	MEDIA_BUS_FMT_SRGGB12_1X12,
+	MEDIA_BUS_FMT_SGBRG12_1X12,
+	MEDIA_BUS_FMT_SRGGB16_1X16,
+};
+
+static const u32 imx900_test_lanes[] = { 1, 2, 3, 4 };
+
+static void imx900_check_rate(struct kunit *test, s64 rate, u32 code,
+							u32 numlanes)
+{
+	const struct imx900_rate_entry *entry = NULL;
+	struct fr_rate_key key;
+	int chromacity, mode, ref;
+
+	if (!fr_rate_key_init(&key, ARRAY_SIZE(imx900_rate_table), rate,
+							code, numlanes))
+		entry = imx900_lookup_rate_entry(&key);
+
+	for (chromacity = IMX900_COLOR; chromacity <= IMX900_MONO; chromacity++) {
+		for (mode = 0; mode <= IMX900_MODE_BINNING_CROP_1024x720; mode++) {
+			ref = imx900_ref_hmax(rate, code, numlanes,
+							chromacity, mode);
+			if (ref < 0) {
+				KUNIT_EXPECT_PTR_EQ_MSG(test, entry, NULL,
+					"rate %lld code 0x%x lanes %u",
+					rate, code, numlanes);
+				continue;
+			}
+
+			KUNIT_ASSERT_NOT_NULL_MSG(test, entry,
+				"rate %lld code 0x%x lanes %u",
+				rate, code, numlanes);
+			KUNIT_EXPECT_EQ_MSG(test, (int)entry->hmax[chromacity]
+					[imx900_rate_mode(mode)], ref,
+				"hmax rate %lld code 0x%x lanes %u chroma %d mode %d",
+				rate, code, numlanes, chromacity, mode);
+
+			ref = imx900_ref_dep(rate, code, numlanes,
+							chromacity, mode);
+			KUNIT_EXPECT_EQ_MSG(test, (int)entry->dep_table[chromacity]
+					[imx900_rate_mode(mode)], ref,
+				"dep rate %lld code 0x%x lanes %u chroma %d mode %d",
+				rate, code, numlanes, chromacity, mode);
+		}
+	}
+}
+
+/*
+ * Walk every data rate, pixel format, lane count, chromacity and sensor
+ * mode and check the table lookup against the reference selection.
+ */
+static void imx900_rate_table_test(struct kunit *test)
+{
+	s64 rate;
+	int c, l;
+
+	for (rate = 0; rate <= IMX900_594_MBPS + 1; rate++)
+		for (c = 0; c < ARRAY_SIZE(imx900_test_codes); c++)
+			for (l = 0; l < ARRAY_SIZE(imx900_test_lanes); l++)
+				imx900_check_rate(test, rate,
+						imx900_test_codes[c],
+						imx900_test_lanes[l]);
+}
+
+static struct kunit_case imx900_rate_test_cases[] = {
+	KUNIT_CASE(imx900_rate_table_test),
+	{}
+};
+
+static struct kunit_suite imx900_rate_test_suite = {
+	.name = "fr_imx900_rate_table",
+	.test_cases = imx900_rate_test_cases,
+};
+
+kunit_test_suite(imx900_rate_test_suite);
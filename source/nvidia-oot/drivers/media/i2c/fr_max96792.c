@@ -13,6 +13,7 @@
 #include <linux/of.h>
 #include <linux/of_device.h>
 #include <linux/of_gpio.h>
+#include <linux/ktime.h>
 #include <media/camera_common.h>
 #include <linux/module.h>
 #include <media/fr_max96792.h>
@@ -106,6 +107,9 @@ struct max96792 {
 	bool splitter_enabled;
 	struct max96792_source_ctx sources[MAX96792_MAX_SOURCES];
 	struct mutex lock;
+	struct mutex serdes_lock;	/* held across one link bring-up */
+	ktime_t serdes_start;
+	ktime_t serdes_wait;
 	u32 sdev_ref;
 	bool lane_setup;
 	bool link_setup;
@@ -243,6 +247,35 @@ void max96792_power_off(struct device *dev, struct gmsl_link_ctx *g_ctx)
 }
 EXPORT_SYMBOL(max96792_power_off);
 
+/*
+ * Serialize the bring-up and teardown of the links sharing this
+ * deserializer. Link select and serializer addressing go through the
+ * deserializer, so links of one device can't be configured in parallel,
+ * while links on different deserializers don't contend at all.
+ */
+void max96792_serdes_lock(struct device *dev)
+{
+	struct max96792 *priv = dev_get_drvdata(dev);
+	ktime_t start = ktime_get();
+
+	mutex_lock(&priv->serdes_lock);
+	priv->serdes_start = ktime_get();
+	priv->serdes_wait = ktime_sub(priv->serdes_start, start);
+}
+EXPORT_SYMBOL(max96792_serdes_lock);
+
+void max96792_serdes_unlock(struct device *dev)
+{
+	struct max96792 *priv = dev_get_drvdata(dev);
+
+	dev_dbg(dev, "%s: link held %lld us, waited %lld us\n", __func__,
+		ktime_us_delta(ktime_get(), priv->serdes_start),
+		ktime_to_us(priv->serdes_wait));
+
+	mutex_unlock(&priv->serdes_lock);
+}
+EXPORT_SYMBOL(max96792_serdes_unlock);
+
 static int max96792_write_link(struct device *dev, u32 link)
 {
 
@@ -844,6 +877,7 @@ static int max96792_probe(struct i2c_client *client,
 	}
 
 	mutex_init(&priv->lock);
+	mutex_init(&priv->serdes_lock);
 
 	dev_set_drvdata(&client->dev, priv);
 
@@ -863,6 +897,7 @@ static void max96792_remove(struct i2c_client *client)
 	if (client != NULL) {
 		priv = dev_get_drvdata(&client->dev);
 		dev_dbg(&client->dev, "Removed max96792 module device\n");
+		mutex_destroy(&priv->serdes_lock);
 		mutex_destroy(&priv->lock);
 		devm_kfree(&client->dev, priv);
 		client = NULL;
@@ -10,6 +10,7 @@
 #include <nvidia/conftest.h>
 #include <media/camera_common.h>
 #include <linux/module.h>
+#include <linux/of.h>
 #include <media/fr_max96793.h>
 
 /* register specifics */
@@ -133,12 +134,19 @@ struct max96793 {
 	struct regmap *regmap;
 	struct max96793_client_ctx g_client;
 	struct mutex lock;
+	/* deserializer the link belongs to */
+	struct device_node *dser_node;
+	/* primary serializer of that deserializer */
+	struct max96793 *prim;
 	/* primary serializer properties */
 	__u32 def_addr;
 	__u32 pst2_ref;
+	struct list_head prim_entry;
 };
 
-static struct max96793 *prim_priv__;
+/* Primary serializers, one per deserializer */
+static LIST_HEAD(prim_list__);
+static DEFINE_MUTEX(prim_lock__);
 
 struct map_ctx {
 	u8 dt;
@@ -147,6 +155,22 @@ struct map_ctx {
 	u8 st_id;
 };
 
+static struct max96793 *max96793_find_prim(struct device_node *dser_node)
+{
+	struct max96793 *prim;
+
+	mutex_lock(&prim_lock__);
+	list_for_each_entry(prim, &prim_list__, prim_entry) {
+		if (prim->dser_node == dser_node)
+			goto ret;
+	}
+	prim = NULL;
+
+ret:
+	mutex_unlock(&prim_lock__);
+	return prim;
+}
+
 static int max96793_write_reg(struct device *dev, u16 addr, u8 val)
 {
 	struct max96793 *priv = dev_get_drvdata(dev);
@@ -307,7 +331,7 @@ int max96793_setup_control(struct device *dev)
 	if (err)
 		dev_err(dev, "error setting i2c speed\n");
 
-	prim_priv__->pst2_ref++;
+	priv->prim->pst2_ref++;
 
 	err = max96793_write_reg(dev, max96793_GPIO0_A, 0x80 | GPIO_RX_EN);
 	if (err)
@@ -392,12 +416,12 @@ int max96793_reset_control(struct device *dev)
 		goto error;
 	}
 
-	prim_priv__->pst2_ref--;
+	priv->prim->pst2_ref--;
 	priv->g_client.st_done = false;
 
-	max96793_write_reg(dev, max96793_DEV_ADDR, (prim_priv__->def_addr << 1));
+	max96793_write_reg(dev, max96793_DEV_ADDR, (priv->prim->def_addr << 1));
 
-	max96793_write_reg(&prim_priv__->i2c_client->dev,
+	max96793_write_reg(&priv->prim->i2c_client->dev,
 				max96793_CTRL0_ADDR, max96793_RESET_ALL);
 
 error:
@@ -424,13 +448,20 @@ int max96793_sdev_pair(struct device *dev, struct gmsl_link_ctx *g_ctx)
 		goto error;
 	}
 
+	priv->prim = max96793_find_prim(priv->dser_node);
+	if (!priv->prim) {
+		dev_err(dev, "%s: no primary serializer found\n", __func__);
+		err = -ENODEV;
+		goto error;
+	}
+
 	priv->g_client.st_done = false;
 
 	priv->g_client.g_ctx = g_ctx;
 
 error:
 	mutex_unlock(&priv->lock);
-	return 0;
+	return err;
 }
 EXPORT_SYMBOL(max96793_sdev_pair);
 
@@ -499,18 +530,24 @@ static int max96793_probe(struct i2c_client *client,
 	}
 
 	mutex_init(&priv->lock);
+	INIT_LIST_HEAD(&priv->prim_entry);
+
+	priv->dser_node = of_parse_phandle(node, "nvidia,gmsl-dser-device", 0);
 
 	if (of_get_property(node, "is-prim-ser", NULL)) {
-		if (prim_priv__)
+		if (max96793_find_prim(priv->dser_node))
 			dev_err(&client->dev, "prim-ser already exists\n");
 
 		err = of_property_read_u32(node, "reg", &priv->def_addr);
 		if (err < 0) {
 			dev_err(&client->dev, "reg not found\n");
+			of_node_put(priv->dser_node);
 			return -EINVAL;
 		}
 
-		prim_priv__ = priv;
+		mutex_lock(&prim_lock__);
+		list_add_tail(&priv->prim_entry, &prim_list__);
+		mutex_unlock(&prim_lock__);
 	}
 
 	dev_set_drvdata(&client->dev, priv);
@@ -531,6 +568,10 @@ static void max96793_remove(struct i2c_client *client)
 	if (client != NULL) {
 		priv = dev_get_drvdata(&client->dev);
 		dev_dbg(&client->dev, "Removed max96792 module device\n");
+		mutex_lock(&prim_lock__);
+		list_del(&priv->prim_entry);
+		mutex_unlock(&prim_lock__);
+		of_node_put(priv->dser_node);
 		mutex_destroy(&priv->lock);
 		devm_kfree(&client->dev, priv);
 		client = NULL;
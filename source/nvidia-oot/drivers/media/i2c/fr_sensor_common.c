@@ -16,13 +16,38 @@
 #include <linux/of.h>
 #include <linux/of_device.h>
 #include <linux/of_gpio.h>
+#include <linux/ktime.h>
+#include <linux/debugfs.h>
 
 #include <media/tegra_v4l2_camera.h>
 #include <media/tegracam_core.h>
+#include <media/tegracam_utils.h>
 
 #include "media/fr_sensor_common.h"
 #include "i2c/fr_i2c_generic.h"
 
+/* bug 200048392 - the vi i2c cannot take a FIFO buffer bigger than 16 bytes */
+#define FR_MAX_BURST_LEN	16
+
+static bool burst_write = true;
+module_param(burst_write, bool, 0644);
+MODULE_PARM_DESC(burst_write,
+	"Coalesce consecutive mode table registers into burst i2c writes");
+
+static bool diff_write = true;
+module_param(diff_write, bool, 0644);
+MODULE_PARM_DESC(diff_write,
+	"Write only mode table registers which differ from the register cache");
+
+static bool blob_ctrls;
+module_param(blob_ctrls, bool, 0444);
+MODULE_PARM_DESC(blob_ctrls,
+	"Packetize group held gain, exposure and frame rate into the control blob");
+
+static bool defer_stop = true;
+module_param(defer_stop, bool, 0644);
+MODULE_PARM_DESC(defer_stop,
+	"Wait for the stopped frame to drain on the next set_mode instead of in stop_streaming");
 
 void fr_calc_lshift(u64 *val, u8 *lshift, s64 max)
 {
@@ -64,20 +89,34 @@ EXPORT_SYMBOL(fr_gpio_set);
 struct v4l2_ctrl *fr_find_v4l2_ctrl(struct tegracam_device *tc_dev, int ctrl_id)
 {
 	struct camera_common_data *s_data = tc_dev->s_data;
-	struct tegracam_ctrl_handler *handler = s_data->tegracam_ctrl_hdl;
-	struct v4l2_ctrl *ctrl;
-	int i;
-
-	for (i = 0; i < handler->numctrls; i++) {
-		ctrl = handler->ctrls[i];
-		if (ctrl->id == ctrl_id)
-			return ctrl;
-	}
 
-	return NULL;
+	return tegracam_find_ctrl(s_data->tegracam_ctrl_hdl, ctrl_id);
 }
 EXPORT_SYMBOL(fr_find_v4l2_ctrl);
 
+static s64 fr_ctrl_cur_value(struct tegracam_device *tc_dev, int ctrl_id)
+{
+	struct v4l2_ctrl *ctrl = fr_find_v4l2_ctrl(tc_dev, ctrl_id);
+
+	return ctrl ? *ctrl->p_cur.p_s64 : 0;
+}
+
+/*
+ * Latch the controls set_mode passes to the sensor. None of them is
+ * adjusted by the drivers while the mode is programmed, controls which
+ * are (data rate, shutter mode) must still be read where they are used.
+ */
+void fr_ctrl_snapshot_take(struct tegracam_device *tc_dev,
+				struct fr_ctrl_snapshot *snap)
+{
+	snap->operation_mode = fr_ctrl_cur_value(tc_dev,
+					TEGRA_CAMERA_CID_OPERATION_MODE);
+	snap->sync_mode = fr_ctrl_cur_value(tc_dev, TEGRA_CAMERA_CID_SYNC_MODE);
+	snap->test_pattern = fr_ctrl_cur_value(tc_dev,
+					TEGRA_CAMERA_CID_TEST_PATTERN);
+}
+EXPORT_SYMBOL(fr_ctrl_snapshot_take);
+
 s64 fr_get_v4l2_ctrl_value(struct tegracam_device *tc_dev,
 				int ctrl_id, v4l2_ctrl_value ctrl_value)
 {
@@ -115,6 +154,23 @@ s64 fr_get_v4l2_ctrl_value(struct tegracam_device *tc_dev,
 }
 EXPORT_SYMBOL(fr_get_v4l2_ctrl_value);
 
+/*
+ * In blob mode only the extended exposure setter is registered. Calling
+ * it without a blob keeps the redirection of an enclosing blob setter,
+ * so a frame rate change packetized into the blob stays in the blob.
+ */
+static int fr_recalc_exposure(struct tegracam_device *tc_dev, s64 val)
+{
+	const struct tegracam_ctrl_ops *ops = tc_dev->tcctrl_ops;
+
+	if (ops->set_exposure)
+		return ops->set_exposure(tc_dev, val);
+	if (ops->set_exposure_ex)
+		return ops->set_exposure_ex(tc_dev, NULL, val);
+
+	return 0;
+}
+
 void fr_update_ctrl_range(struct tegracam_device *tc_dev,
 						int ctrl_id, u64 min, u64 max)
 {
@@ -138,7 +194,7 @@ void fr_update_ctrl_range(struct tegracam_device *tc_dev,
 			/* Current value must be recalculated */
 			dev_dbg(dev, "%s: recalculate exposure for set frame length.\n",
 									__func__);
-			err = ops->set_exposure(tc_dev, *ctrl->p_cur.p_s64);
+			err = fr_recalc_exposure(tc_dev, *ctrl->p_cur.p_s64);
 
 			dev_dbg(dev, "%s: mode: %u, exposure range [%llu, %llu]\n",
 				__func__, s_data->mode, s_data->exposure_min_range,
@@ -151,7 +207,9 @@ void fr_update_ctrl_range(struct tegracam_device *tc_dev,
 			/* Current value must be recalculated */
 			dev_dbg(dev, "%s: recalculate short exposure for set frame length.\n",
 									__func__);
-			err = ops->set_exposure_short(tc_dev, *ctrl->p_cur.p_s64);
+			if (ops->set_exposure_short)
+				err = ops->set_exposure_short(tc_dev,
+							*ctrl->p_cur.p_s64);
 
 			dev_dbg(dev, "%s: mode: %u, short exposure range [%llu, %llu]\n",
 				__func__, s_data->mode, s_data->short_exposure_min_range,
@@ -179,6 +237,89 @@ void fr_update_ctrl_range(struct tegracam_device *tc_dev,
 }
 EXPORT_SYMBOL(fr_update_ctrl_range);
 
+static int fr_bpp_index(u32 code)
+{
+	switch (code) {
+	case MEDIA_BUS_FMT_SBGGR8_1X8:
+	case MEDIA_BUS_FMT_SGBRG8_1X8:
+	case MEDIA_BUS_FMT_SGRBG8_1X8:
+	case MEDIA_BUS_FMT_SRGGB8_1X8:
+		return FR_BPP_8;
+	case MEDIA_BUS_FMT_SBGGR10_1X10:
+	case MEDIA_BUS_FMT_SGBRG10_1X10:
+	case MEDIA_BUS_FMT_SGRBG10_1X10:
+	case MEDIA_BUS_FMT_SRGGB10_1X10:
+		return FR_BPP_10;
+	case MEDIA_BUS_FMT_SBGGR12_1X12:
+	case MEDIA_BUS_FMT_SGBRG12_1X12:
+	case MEDIA_BUS_FMT_SGRBG12_1X12:
+	case MEDIA_BUS_FMT_SRGGB12_1X12:
+		return FR_BPP_12;
+	case MEDIA_BUS_FMT_SBGGR16_1X16:
+	case MEDIA_BUS_FMT_SGBRG16_1X16:
+	case MEDIA_BUS_FMT_SGRBG16_1X16:
+	case MEDIA_BUS_FMT_SRGGB16_1X16:
+		return FR_BPP_16;
+	default:
+		return -EINVAL;
+	}
+}
+
+static int fr_lane_index(u32 numlanes)
+{
+	switch (numlanes) {
+	case 1:
+		return FR_LANES_1;
+	case 2:
+		return FR_LANES_2;
+	case 4:
+		return FR_LANES_4;
+	default:
+		return -EINVAL;
+	}
+}
+
+/*
+ * Build the [data rate][bpp][lanes] index of the per-sensor rate tables.
+ * Returns -ERANGE when the data rate has no table row and -EINVAL when
+ * the pixel format or lane count has no table column.
+ */
+int fr_rate_key_init(struct fr_rate_key *key, u32 num_rates, s64 rate,
+					u32 code, u32 numlanes)
+{
+	int bpp, lanes;
+
+	if (rate < 0 || rate >= num_rates)
+		return -ERANGE;
+
+	bpp = fr_bpp_index(code);
+	lanes = fr_lane_index(numlanes);
+	if (bpp < 0 || lanes < 0)
+		return -EINVAL;
+
+	key->rate = rate;
+	key->bpp = bpp;
+	key->lanes = lanes;
+
+	return 0;
+}
+EXPORT_SYMBOL(fr_rate_key_init);
+
+/* Rate table index of the current data rate, pixel format and lane count */
+int fr_rate_key_get(struct tegracam_device *tc_dev, u32 num_rates,
+					struct fr_rate_key *key)
+{
+	struct camera_common_data *s_data = tc_dev->s_data;
+	s64 rate;
+
+	rate = fr_get_v4l2_ctrl_value(tc_dev, TEGRA_CAMERA_CID_DATA_RATE,
+								CURRENT);
+
+	return fr_rate_key_init(key, num_rates, rate, s_data->colorfmt->code,
+							s_data->numlanes);
+}
+EXPORT_SYMBOL(fr_rate_key_get);
+
 /* Get I2C broadcast client */
 int common_get_broadcast_client(struct tegracam_device *tc_dev,
 	struct v4l2_ctrl *ctrl, const struct regmap_config *sensor_regmap_config)
@@ -216,6 +357,705 @@ int common_get_broadcast_client(struct tegracam_device *tc_dev,
 }
 EXPORT_SYMBOL(common_get_broadcast_client);
 
+static int fr_write_range(struct regmap *regmap, u16 addr,
+			const u8 *vals, u32 count, struct fr_table_stats *stats)
+{
+	int err = 0;
+	int i;
+
+	if (burst_write) {
+		if (count == 1)
+			err = regmap_write(regmap, addr, vals[0]);
+		else
+			err = regmap_bulk_write(regmap, addr, vals, count);
+		stats->xfers++;
+	} else {
+		for (i = 0; i < count && !err; i++) {
+			err = regmap_write(regmap, addr + i, vals[i]);
+			stats->xfers++;
+		}
+	}
+
+	stats->regs += count;
+
+	return err;
+}
+
+/*
+ * Write a mode table, coalescing consecutive addresses into bursts of up to
+ * FR_MAX_BURST_LEN registers. Sensor regmaps must not set use_single_write,
+ * otherwise regmap splits every burst back into single register transfers.
+ */
+int fr_write_table_8(struct regmap *regmap, const struct reg_8 table[],
+		u16 wait_ms_addr, u16 end_addr, struct fr_table_stats *stats)
+{
+	const struct reg_8 *next;
+	u8 range_vals[FR_MAX_BURST_LEN];
+	u32 range_count = 0;
+	u16 range_start = 0;
+	int err;
+
+	for (next = table;; next++) {
+		if (range_count &&
+		    ((next->addr != range_start + range_count) ||
+		     (next->addr == end_addr) ||
+		     (next->addr == wait_ms_addr) ||
+		     (range_count == FR_MAX_BURST_LEN))) {
+			err = fr_write_range(regmap, range_start,
+					range_vals, range_count, stats);
+			if (err) {
+				pr_err("%s: write at 0x%x failed: %d\n",
+					__func__, range_start, err);
+				return err;
+			}
+			range_count = 0;
+		}
+
+		if (next->addr == end_addr)
+			break;
+
+		if (next->addr == wait_ms_addr) {
+			msleep_range(next->val);
+			stats->sleep_ms += next->val;
+			continue;
+		}
+
+		if (!range_count)
+			range_start = next->addr;
+
+		range_vals[range_count++] = next->val;
+	}
+
+	return 0;
+}
+EXPORT_SYMBOL(fr_write_table_8);
+
+/*
+ * Compile a mode table into a packed list of coalesced runs, so replaying
+ * it does not have to walk and branch on every table entry again.
+ */
+static int fr_compile_table(struct device *dev, struct fr_table_blob *blob,
+			const struct reg_8 table[], u16 wait_ms_addr, u16 end_addr)
+{
+	const struct reg_8 *next;
+	struct fr_reg_run *runs;
+	struct fr_reg_run *run = NULL;
+	u8 *payload;
+	u32 num_runs = 0;
+	u32 num_vals = 0;
+	u32 offset = 0;
+	u16 run_addr = 0;
+	u16 run_len = 0;
+
+	/* First pass sizes the run list and the payload */
+	for (next = table; next->addr != end_addr; next++) {
+		if (next->addr == wait_ms_addr) {
+			num_runs++;
+			run_len = 0;
+			continue;
+		}
+
+		if (!run_len || run_len == FR_MAX_BURST_LEN ||
+		    next->addr != run_addr + run_len) {
+			num_runs++;
+			run_addr = next->addr;
+			run_len = 0;
+		}
+		run_len++;
+		num_vals++;
+	}
+
+	runs = devm_kcalloc(dev, num_runs, sizeof(*runs), GFP_KERNEL);
+	payload = devm_kzalloc(dev, num_vals ? num_vals : 1, GFP_KERNEL);
+	if (!runs || !payload)
+		return -ENOMEM;
+
+	num_runs = 0;
+	for (next = table; next->addr != end_addr; next++) {
+		if (next->addr == wait_ms_addr) {
+			run = &runs[num_runs++];
+			run->addr = wait_ms_addr;
+			run->len = 0;
+			run->val = next->val;
+			run = NULL;
+			continue;
+		}
+
+		if (!run || run->len == FR_MAX_BURST_LEN ||
+		    next->addr != run->addr + run->len) {
+			run = &runs[num_runs++];
+			run->addr = next->addr;
+			run->len = 0;
+			run->val = offset;
+		}
+		payload[offset++] = next->val;
+		run->len++;
+	}
+
+	blob->table = table;
+	blob->runs = runs;
+	blob->payload = payload;
+	blob->num_runs = num_runs;
+
+	return 0;
+}
+
+/* Compile a set of mode tables at probe time, NULL entries are skipped */
+int fr_table_cache_add(struct device *dev, struct fr_table_cache *cache,
+			const struct reg_8 * const tables[], u32 num_tables,
+			u16 wait_ms_addr, u16 end_addr)
+{
+	struct fr_table_blob *blobs;
+	u32 num_blobs = cache->num_blobs;
+	int err;
+	int i;
+
+	blobs = devm_kcalloc(dev, cache->num_blobs + num_tables,
+					sizeof(*blobs), GFP_KERNEL);
+	if (!blobs)
+		return -ENOMEM;
+
+	if (cache->blobs) {
+		memcpy(blobs, cache->blobs, cache->num_blobs * sizeof(*blobs));
+		devm_kfree(dev, cache->blobs);
+	}
+
+	for (i = 0; i < num_tables; i++) {
+		if (!tables[i])
+			continue;
+
+		err = fr_compile_table(dev, &blobs[num_blobs], tables[i],
+						wait_ms_addr, end_addr);
+		if (err) {
+			dev_err(dev, "%s: unable to compile table %d\n",
+				__func__, i);
+			cache->blobs = blobs;
+			return err;
+		}
+		num_blobs++;
+	}
+
+	cache->blobs = blobs;
+	cache->num_blobs = num_blobs;
+
+	dev_dbg(dev, "%s: %u mode tables compiled\n", __func__, num_blobs);
+
+	return 0;
+}
+EXPORT_SYMBOL(fr_table_cache_add);
+
+static const struct fr_table_blob *fr_table_cache_find(
+		const struct fr_table_cache *cache, const struct reg_8 table[])
+{
+	int i;
+
+	for (i = 0; i < cache->num_blobs; i++) {
+		if (cache->blobs[i].table == table)
+			return &cache->blobs[i];
+	}
+
+	return NULL;
+}
+
+static int fr_write_blob(struct regmap *regmap,
+		const struct fr_table_blob *blob, struct fr_table_stats *stats)
+{
+	const struct fr_reg_run *run;
+	int err;
+	int i;
+
+	for (i = 0; i < blob->num_runs; i++) {
+		run = &blob->runs[i];
+
+		if (!run->len) {
+			msleep_range(run->val);
+			stats->sleep_ms += run->val;
+			continue;
+		}
+
+		err = fr_write_range(regmap, run->addr,
+				&blob->payload[run->val], run->len, stats);
+		if (err) {
+			pr_err("%s: write at 0x%x failed: %d\n",
+				__func__, run->addr, err);
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Write only the registers of each run which differ from the regmap cache.
+ * A run is rewritten from its first to its last changed register in one
+ * burst, and table sleeps are skipped while nothing has been written.
+ */
+static int fr_write_blob_diff(struct regmap *regmap,
+		const struct fr_table_blob *blob, struct fr_table_stats *stats)
+{
+	const struct fr_reg_run *run;
+	const u8 *vals;
+	unsigned int reg;
+	bool written = false;
+	int first, last;
+	int err;
+	int i, j;
+
+	for (i = 0; i < blob->num_runs; i++) {
+		run = &blob->runs[i];
+
+		if (!run->len) {
+			if (written) {
+				msleep_range(run->val);
+				stats->sleep_ms += run->val;
+			}
+			written = false;
+			continue;
+		}
+
+		vals = &blob->payload[run->val];
+		first = -1;
+		last = -1;
+
+		for (j = 0; j < run->len; j++) {
+			err = regmap_read(regmap, run->addr + j, &reg);
+			if (err || reg != vals[j]) {
+				if (first < 0)
+					first = j;
+				last = j;
+			}
+		}
+
+		if (first < 0) {
+			stats->skipped += run->len;
+			continue;
+		}
+
+		stats->skipped += run->len - (last - first + 1);
+
+		err = fr_write_range(regmap, run->addr + first, &vals[first],
+						last - first + 1, stats);
+		if (err) {
+			pr_err("%s: write at 0x%x failed: %d\n",
+				__func__, run->addr + first, err);
+			return err;
+		}
+		written = true;
+	}
+
+	return 0;
+}
+
+/*
+ * Drop the register cache once the sensor lost its state, so the next
+ * set_mode falls back to writing the complete mode tables.
+ */
+void fr_table_cache_invalidate(struct regmap *regmap,
+					struct fr_table_cache *cache)
+{
+	regcache_drop_region(regmap, 0, U16_MAX);
+	cache->synced = false;
+	cache->diff = false;
+}
+EXPORT_SYMBOL(fr_table_cache_invalidate);
+
+/*
+ * Mode tables written between fr_table_cache_begin_mode() and a successful
+ * fr_table_cache_end_mode() are diffed against the register cache, as long
+ * as a complete set_mode has been written since the last power cycle.
+ * Broadcast writes bypass the per-sensor cache, but they only touch gain,
+ * exposure and frame length, which the control overrides reprogram after
+ * every set_mode.
+ */
+void fr_table_cache_begin_mode(struct fr_table_cache *cache)
+{
+	cache->diff = cache->synced && diff_write;
+	cache->synced = false;
+}
+EXPORT_SYMBOL(fr_table_cache_begin_mode);
+
+void fr_table_cache_end_mode(struct fr_table_cache *cache)
+{
+	cache->diff = false;
+	cache->synced = true;
+}
+EXPORT_SYMBOL(fr_table_cache_end_mode);
+
+/*
+ * Replay the precompiled run list of a table, tables which were not
+ * registered with fr_table_cache_add() are written directly.
+ */
+int fr_write_table_cached(struct regmap *regmap,
+		const struct fr_table_cache *cache, const struct reg_8 table[],
+		u16 wait_ms_addr, u16 end_addr, struct fr_table_stats *stats)
+{
+	const struct fr_table_blob *blob;
+
+	blob = fr_table_cache_find(cache, table);
+	if (!blob)
+		return fr_write_table_8(regmap, table, wait_ms_addr,
+						end_addr, stats);
+
+	if (cache->diff)
+		return fr_write_blob_diff(regmap, blob, stats);
+
+	return fr_write_blob(regmap, blob, stats);
+}
+EXPORT_SYMBOL(fr_write_table_cached);
+
+void fr_table_stats_begin(struct fr_table_stats *stats)
+{
+	stats->regs = 0;
+	stats->skipped = 0;
+	stats->xfers = 0;
+	stats->sleep_ms = 0;
+	stats->start = ktime_get();
+}
+EXPORT_SYMBOL(fr_table_stats_begin);
+
+void fr_table_stats_end(struct device *dev, struct fr_table_stats *stats,
+								int mode)
+{
+	dev_dbg(dev,
+		"mode %d: %u registers in %u i2c %s transfers, %u unchanged, %u ms table sleep, %lld us total\n",
+		mode, stats->regs, stats->xfers,
+		burst_write ? "burst" : "single", stats->skipped,
+		stats->sleep_ms,
+		ktime_us_delta(ktime_get(), stats->start));
+}
+EXPORT_SYMBOL(fr_table_stats_end);
+
+void fr_stream_stop_begin(struct fr_stop_ctx *ctx)
+{
+	ctx->start = ktime_get();
+}
+EXPORT_SYMBOL(fr_stream_stop_begin);
+
+/*
+ * The sensor finishes the frame in flight after the stop table is
+ * written. Nothing may be reprogrammed until it has drained, but power
+ * off and the VI teardown don't care, so by default the wait is moved
+ * to the next fr_stream_settle() and only the part of the frame which
+ * has not already elapsed is slept there. The stop latency counts that
+ * sleep too, so it stays comparable with and without defer_stop.
+ */
+void fr_stream_stop_end(struct fr_stop_ctx *ctx, u64 frame_us)
+{
+	ctx->settle = ktime_add_us(ktime_get(), frame_us);
+	ctx->last_us = ktime_us_delta(ktime_get(), ctx->start);
+	ctx->max_us = max(ctx->max_us, ctx->last_us);
+
+	if (!defer_stop)
+		fr_stream_settle(ctx);
+}
+EXPORT_SYMBOL(fr_stream_stop_end);
+
+void fr_stream_settle(struct fr_stop_ctx *ctx)
+{
+	ktime_t start;
+	s64 left_us;
+	u32 slept_us;
+
+	if (!ctx->settle)
+		return;
+
+	start = ktime_get();
+	left_us = ktime_us_delta(ctx->settle, start);
+	if (left_us > 0) {
+		usleep_range(left_us, left_us + 1000);
+		slept_us = ktime_us_delta(ktime_get(), start);
+		ctx->settle_us += slept_us;
+		ctx->last_us += slept_us;
+		ctx->max_us = max(ctx->max_us, ctx->last_us);
+	}
+	ctx->settle = 0;
+}
+EXPORT_SYMBOL(fr_stream_settle);
+
+void fr_stop_debugfs_init(struct device *dev, struct fr_stop_ctx *ctx)
+{
+	char name[48];
+
+	snprintf(name, sizeof(name), "%s-%s", dev->driver->name, dev_name(dev));
+	ctx->debugfs_dir = debugfs_create_dir(name, NULL);
+	if (IS_ERR_OR_NULL(ctx->debugfs_dir)) {
+		ctx->debugfs_dir = NULL;
+		return;
+	}
+
+	debugfs_create_u32("stop_latency_us", 0444, ctx->debugfs_dir,
+						&ctx->last_us);
+	debugfs_create_u32("stop_latency_max_us", 0644, ctx->debugfs_dir,
+						&ctx->max_us);
+	debugfs_create_u32("stop_settle_us", 0644, ctx->debugfs_dir,
+						&ctx->settle_us);
+}
+EXPORT_SYMBOL(fr_stop_debugfs_init);
+
+void fr_stop_debugfs_remove(struct fr_stop_ctx *ctx)
+{
+	debugfs_remove_recursive(ctx->debugfs_dir);
+	ctx->debugfs_dir = NULL;
+}
+EXPORT_SYMBOL(fr_stop_debugfs_remove);
+
+/*
+ * Multi-byte sensor registers (exposure, gain, frame length) are accessed
+ * with a single i2c_transfer: register hold set, the value bytes in one
+ * auto-increment message and register hold release. The adapter stays
+ * locked for the whole transfer, so the sensor latches all bytes in the
+ * same frame and an update costs one queued transfer instead of 2 + N.
+ */
+#define FR_MAX_BUFFERED_LEN	8
+
+static inline unsigned int fr_buffered_shift(u8 num_regs, int i,
+							bool msb_first)
+{
+	return (msb_first ? num_regs - 1 - i : i) * 8;
+}
+
+static inline void fr_buffered_hold_msg(struct i2c_msg *msg,
+				struct i2c_client *client, u8 *buf,
+				u16 hold_addr, u8 val)
+{
+	buf[0] = hold_addr >> 8;
+	buf[1] = hold_addr & 0xff;
+	buf[2] = val;
+
+	msg->addr = client->addr;
+	msg->flags = 0;
+	msg->len = 3;
+	msg->buf = buf;
+}
+
+/*
+ * The transfer bypasses regmap, so drop the cached copies and let later
+ * reads and differential mode table writes go to the sensor. A broadcast
+ * write reaches this sensor as well.
+ */
+static void fr_buffered_cache_drop(struct camera_common_data *s_data,
+				struct regmap *regmap, u16 hold_addr,
+				u16 addr, u8 num_regs)
+{
+	regcache_drop_region(regmap, addr, addr + num_regs - 1);
+	regcache_drop_region(regmap, hold_addr, hold_addr);
+
+	if (regmap != s_data->regmap) {
+		regcache_drop_region(s_data->regmap, addr,
+					addr + num_regs - 1);
+		regcache_drop_region(s_data->regmap, hold_addr, hold_addr);
+	}
+}
+
+/*
+ * addr_low is the address of the least significant byte, msb_first
+ * registers (CCI style) keep the more significant bytes below it.
+ */
+int fr_write_buffered_reg(struct camera_common_data *s_data,
+		struct regmap *regmap, u16 hold_addr, u16 addr_low,
+		u8 num_regs, u64 val, bool msb_first)
+{
+	struct i2c_client *client = i2c_verify_client(regmap_get_device(regmap));
+	struct device *dev = s_data->dev;
+	u8 hold_set[3], hold_release[3];
+	u8 buf[2 + FR_MAX_BUFFERED_LEN];
+	struct i2c_msg msgs[3];
+	int num_msgs = 0;
+	u16 addr;
+	int err, i;
+
+	if (!client || !num_regs || num_regs > FR_MAX_BUFFERED_LEN)
+		return -EINVAL;
+
+	addr = msb_first ? addr_low - (num_regs - 1) : addr_low;
+	buf[0] = addr >> 8;
+	buf[1] = addr & 0xff;
+	for (i = 0; i < num_regs; i++)
+		buf[2 + i] = (u8)(val >> fr_buffered_shift(num_regs, i,
+								msb_first));
+
+	if (!s_data->group_hold_active)
+		fr_buffered_hold_msg(&msgs[num_msgs++], client, hold_set,
+							hold_addr, 0x01);
+
+	msgs[num_msgs].addr = client->addr;
+	msgs[num_msgs].flags = 0;
+	msgs[num_msgs].len = 2 + num_regs;
+	msgs[num_msgs].buf = buf;
+	num_msgs++;
+
+	if (!s_data->group_hold_active)
+		fr_buffered_hold_msg(&msgs[num_msgs++], client, hold_release,
+							hold_addr, 0x00);
+
+	err = i2c_transfer(client->adapter, msgs, num_msgs);
+	fr_buffered_cache_drop(s_data, regmap, hold_addr, addr, num_regs);
+	if (err != num_msgs) {
+		dev_err(dev, "%s: BUFFERED register write error, 0x%x\n",
+							__func__, addr_low);
+		return err < 0 ? err : -EIO;
+	}
+
+	return 0;
+}
+EXPORT_SYMBOL(fr_write_buffered_reg);
+
+int fr_read_buffered_reg(struct camera_common_data *s_data,
+		struct regmap *regmap, u16 hold_addr, u16 addr_low,
+		u8 num_regs, u64 *val, bool msb_first)
+{
+	struct i2c_client *client = i2c_verify_client(regmap_get_device(regmap));
+	struct device *dev = s_data->dev;
+	u8 hold_set[3], hold_release[3];
+	u8 addr_buf[2], buf[FR_MAX_BUFFERED_LEN];
+	struct i2c_msg msgs[4];
+	int num_msgs = 0;
+	u16 addr;
+	int err, i;
+
+	*val = 0;
+
+	if (!client || !num_regs || num_regs > FR_MAX_BUFFERED_LEN)
+		return -EINVAL;
+
+	addr = msb_first ? addr_low - (num_regs - 1) : addr_low;
+	addr_buf[0] = addr >> 8;
+	addr_buf[1] = addr & 0xff;
+
+	if (!s_data->group_hold_active)
+		fr_buffered_hold_msg(&msgs[num_msgs++], client, hold_set,
+							hold_addr, 0x01);
+
+	msgs[num_msgs].addr = client->addr;
+	msgs[num_msgs].flags = 0;
+	msgs[num_msgs].len = 2;
+	msgs[num_msgs].buf = addr_buf;
+	num_msgs++;
+
+	msgs[num_msgs].addr = client->addr;
+	msgs[num_msgs].flags = I2C_M_RD;
+	msgs[num_msgs].len = num_regs;
+	msgs[num_msgs].buf = buf;
+	num_msgs++;
+
+	if (!s_data->group_hold_active)
+		fr_buffered_hold_msg(&msgs[num_msgs++], client, hold_release,
+							hold_addr, 0x00);
+
+	err = i2c_transfer(client->adapter, msgs, num_msgs);
+	if (!s_data->group_hold_active)
+		regcache_drop_region(regmap, hold_addr, hold_addr);
+	if (err != num_msgs) {
+		dev_err(dev, "%s: error reading buffered registers, 0x%x\n",
+							__func__, addr_low);
+		return err < 0 ? err : -EIO;
+	}
+
+	for (i = 0; i < num_regs; i++)
+		*val |= (u64)buf[i] << fr_buffered_shift(num_regs, i, msb_first);
+
+	return 0;
+}
+EXPORT_SYMBOL(fr_read_buffered_reg);
+
+/*
+ * FRAMOS ops tables carry both the direct and the blob variants of the
+ * gain, exposure, frame rate and group hold controls. tegracam refuses
+ * to mix them, so copy the table into the device and keep the set
+ * selected by the blob_ctrls parameter. The shared table stays const,
+ * sensors probe asynchronously.
+ */
+void fr_select_ctrl_ops(struct tegracam_ctrl_ops *ops,
+			const struct tegracam_ctrl_ops *tmpl)
+{
+	*ops = *tmpl;
+	ops->is_blob_supported = blob_ctrls;
+
+	if (blob_ctrls) {
+		ops->set_gain = NULL;
+		ops->set_exposure = NULL;
+		ops->set_frame_rate = NULL;
+		ops->set_group_hold = NULL;
+	} else {
+		ops->set_gain_ex = NULL;
+		ops->set_exposure_ex = NULL;
+		ops->set_frame_rate_ex = NULL;
+		ops->set_group_hold_ex = NULL;
+	}
+}
+EXPORT_SYMBOL(fr_select_ctrl_ops);
+
+int fr_set_group_hold_ex(struct fr_ctrl_blob *ctrl_blob,
+			struct sensor_blob *blob, u16 hold_addr, bool val)
+{
+	u8 reg_val = val;
+
+	ctrl_blob->hold = val;
+
+	return prepare_write_cmd(blob, 1, hold_addr, &reg_val);
+}
+EXPORT_SYMBOL(fr_set_group_hold_ex);
+
+/*
+ * Run a direct control setter with its buffered register writes
+ * redirected into the blob. Only group held updates of a streaming
+ * sensor are packetized, the blob is flushed when the group hold is
+ * released and on every capture request. Anything else, including the
+ * overrides written before stream on, goes to the sensor right away.
+ * A nested call without a blob keeps the redirection of the caller.
+ */
+int fr_set_ctrl_ex(struct tegracam_device *tc_dev,
+		struct fr_ctrl_blob *ctrl_blob, struct sensor_blob *blob,
+		int (*set_ctrl)(struct tegracam_device *tc_dev, s64 val),
+		s64 val)
+{
+	struct sensor_blob *prev = ctrl_blob->blob;
+	int err;
+
+	if (blob && tc_dev->is_streaming && ctrl_blob->hold)
+		ctrl_blob->blob = blob;
+
+	err = set_ctrl(tc_dev, val);
+	ctrl_blob->blob = prev;
+
+	return err;
+}
+EXPORT_SYMBOL(fr_set_ctrl_ex);
+
+int fr_blob_buffered_reg(struct fr_ctrl_blob *ctrl_blob, u16 hold_addr,
+			u16 addr_low, u8 num_regs, u64 val, bool msb_first)
+{
+	u8 buf[FR_MAX_BUFFERED_LEN];
+	u8 hold_set = 0x01, hold_release = 0x00;
+	u16 addr;
+	int err, i;
+
+	if (!num_regs || num_regs > FR_MAX_BUFFERED_LEN)
+		return -EINVAL;
+
+	addr = msb_first ? addr_low - (num_regs - 1) : addr_low;
+	for (i = 0; i < num_regs; i++)
+		buf[i] = (u8)(val >> fr_buffered_shift(num_regs, i, msb_first));
+
+	if (!ctrl_blob->hold) {
+		err = prepare_write_cmd(ctrl_blob->blob, 1, hold_addr,
+								&hold_set);
+		if (err)
+			return err;
+	}
+
+	err = prepare_write_cmd(ctrl_blob->blob, num_regs, addr, buf);
+	if (err)
+		return err;
+
+	if (!ctrl_blob->hold)
+		err = prepare_write_cmd(ctrl_blob->blob, 1, hold_addr,
+							&hold_release);
+
+	return err;
+}
+EXPORT_SYMBOL(fr_blob_buffered_reg);
+
 MODULE_DESCRIPTION("Framos Image Sensor common logic");
 MODULE_AUTHOR("FRAMOS GmbH");
 MODULE_LICENSE("GPL v2");
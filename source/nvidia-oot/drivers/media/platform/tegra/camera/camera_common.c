@@ -16,6 +16,8 @@
 #include <soc/tegra/tegra-i2c-rtcpu.h>
 #include <linux/arm64-barrier.h>
 #include <linux/nospec.h>
+#include <linux/bsearch.h>
+#include <linux/sort.h>
 
 #define has_s_op(master, op) \
 	(master->ops && master->ops->op)
@@ -550,14 +552,100 @@ int camera_common_enum_fmt(struct v4l2_subdev *sd, unsigned int index,
 }
 EXPORT_SYMBOL_GPL(camera_common_enum_fmt);
 
+static int fmt_index_cmp(const void *a, const void *b)
+{
+	const struct camera_common_fmt_index *x = a;
+	const struct camera_common_fmt_index *y = b;
+
+	if (x->width != y->width)
+		return x->width < y->width ? -1 : 1;
+	if (x->height != y->height)
+		return x->height < y->height ? -1 : 1;
+
+	return 0;
+}
+
+static const struct camera_common_fmt_index *find_fmt_index(
+		struct camera_common_data *s_data, u32 width, u32 height)
+{
+	struct camera_common_fmt_index key = {
+		.width = width,
+		.height = height,
+	};
+
+	return bsearch(&key, s_data->fmt_index, s_data->num_fmt_index,
+			sizeof(key), fmt_index_cmp);
+}
+
+int camera_common_build_fmt_index(struct camera_common_data *s_data)
+{
+	const struct camera_common_frmfmt *frmfmt = s_data->frmfmt;
+	struct camera_common_fmt_index *index;
+	int num = 0;
+	int i, j;
+
+	s_data->fmt_index = NULL;
+	s_data->num_fmt_index = 0;
+	s_data->has_hdr_fmts = false;
+
+	if (!frmfmt || s_data->numfmts <= 0)
+		return 0;
+
+	index = devm_kcalloc(s_data->dev, s_data->numfmts, sizeof(*index),
+			GFP_KERNEL);
+	if (!index)
+		return -ENOMEM;
+
+	/* keep the first entry of each size, as the linear scan did */
+	for (i = 0; i < s_data->numfmts; i++) {
+		for (j = 0; j < num; j++)
+			if (index[j].width == frmfmt[i].size.width &&
+			    index[j].height == frmfmt[i].size.height)
+				break;
+
+		if (j == num) {
+			index[j].width = frmfmt[i].size.width;
+			index[j].height = frmfmt[i].size.height;
+			index[j].idx = i;
+			index[j].hdr_idx = -1;
+			num++;
+		}
+
+		if (frmfmt[i].hdr_en) {
+			s_data->has_hdr_fmts = true;
+			if (index[j].hdr_idx < 0)
+				index[j].hdr_idx = i;
+		}
+	}
+
+	sort(index, num, sizeof(*index), fmt_index_cmp, NULL);
+
+	s_data->fmt_index = index;
+	s_data->num_fmt_index = num;
+
+	return 0;
+}
+EXPORT_SYMBOL_GPL(camera_common_build_fmt_index);
+
 static void select_mode(struct camera_common_data *s_data,
 			struct v4l2_mbus_framefmt *mf,
 			unsigned int mode_type)
 {
 	int i;
 	const struct camera_common_frmfmt *frmfmt = s_data->frmfmt;
+	const struct camera_common_fmt_index *entry;
 	bool flag = 0;
 
+	if (s_data->fmt_index) {
+		entry = find_fmt_index(s_data, mf->width, mf->height);
+		if (entry && (mode_type & HDR_ENABLE) && entry->hdr_idx >= 0) {
+			i = array_index_nospec(entry->hdr_idx, s_data->numfmts);
+			s_data->mode = frmfmt[i].mode;
+			s_data->mode_prop_idx = i;
+		}
+		return;
+	}
+
 	for (i = 0; i < s_data->numfmts; i++) {
 		if (mode_type & HDR_ENABLE)
 			flag = !frmfmt[i].hdr_en;
@@ -584,6 +672,7 @@ int camera_common_try_fmt(struct v4l2_subdev *sd, struct v4l2_mbus_framefmt *mf)
 	struct tegra_channel *chan = v4l2_get_subdev_hostdata(sd);
 	struct v4l2_control hdr_control;
 	const struct camera_common_frmfmt *frmfmt;
+	const struct camera_common_fmt_index *entry;
 	unsigned int mode_type = 0;
 	int err = 0;
 	int i;
@@ -596,11 +685,12 @@ int camera_common_try_fmt(struct v4l2_subdev *sd, struct v4l2_mbus_framefmt *mf)
 
 	frmfmt = s_data->frmfmt;
 
-	/* check hdr enable ctrl */
+	/* check hdr enable ctrl, it cannot change the mode without hdr modes */
 	hdr_control.id = TEGRA_CAMERA_CID_HDR_EN;
 
 	/* mode_type can be filled in sensor driver */
-	if (!(v4l2_g_ctrl(s_data->ctrl_handler, &hdr_control)))
+	if ((!s_data->fmt_index || s_data->has_hdr_fmts) &&
+	    !(v4l2_g_ctrl(s_data->ctrl_handler, &hdr_control)))
 		mode_type |=
 			switch_ctrl_qmenu[hdr_control.value] ? HDR_ENABLE : 0;
 
@@ -630,6 +720,26 @@ int camera_common_try_fmt(struct v4l2_subdev *sd, struct v4l2_mbus_framefmt *mf)
 				__func__, mf->width, mf->height);
 			goto verify_code;
 		}
+	} else if (s_data->fmt_index) {
+		/* select mode based on format match first */
+		entry = find_fmt_index(s_data, mf->width, mf->height);
+		if (!entry) {
+			mf->width = s_data->fmt_width;
+			mf->height = s_data->fmt_height;
+			dev_dbg(sd->dev,
+				"%s: invalid resolution supplied to set mode %d %d\n",
+				__func__, mf->width, mf->height);
+			goto verify_code;
+		}
+		i = array_index_nospec(entry->idx, s_data->numfmts);
+		s_data->mode = frmfmt[i].mode;
+		s_data->mode_prop_idx = i;
+		s_data->fmt_width = mf->width;
+		s_data->fmt_height = mf->height;
+
+		/* update mode based on special mode types */
+		if (mode_type)
+			select_mode(s_data, mf, mode_type);
 	} else {
 		/* select mode based on format match first */
 		for (i = 0; i < s_data->numfmts; i++) {
@@ -7,6 +7,7 @@
  * @brief VI channel operations for the T234 Camera RTCPU platform.
  */
 
+#include <linux/bitmap.h>
 #include <linux/completion.h>
 #include <linux/nospec.h>
 #include <linux/nvhost.h>
@@ -297,6 +298,21 @@ static void vi_capture_ivc_status_callback(
 			buffer_index * capture->request_size,
 			capture->request_size, DMA_FROM_DEVICE);
 
+		if (likely(capture->requests_done != NULL &&
+				buffer_index < capture->queue_depth)) {
+			/* order the status write-back before the done bit */
+			smp_mb__before_atomic();
+			set_bit(buffer_index, capture->requests_done);
+			wake_up(&capture->status_wait);
+
+			spin_lock(&capture->notify_lock);
+			if (capture->status_notify)
+				capture->status_notify(
+					capture->status_notify_data,
+					buffer_index);
+			spin_unlock(&capture->notify_lock);
+		}
+
 		if (capture->is_progress_status_notifier_set) {
 			capture_common_set_progress_status(
 					&capture->progress_status_notifier,
@@ -472,6 +488,8 @@ int vi_capture_init(
 
 	init_completion(&capture->control_resp);
 	init_completion(&capture->capture_resp);
+	init_waitqueue_head(&capture->status_wait);
+	spin_lock_init(&capture->notify_lock);
 
 	mutex_init(&capture->reset_lock);
 	mutex_init(&capture->control_msg_lock);
@@ -527,6 +545,7 @@ void vi_capture_shutdown(
 		vfree(capture->unpins_list);
 		capture->unpins_list = NULL;
 	}
+	bitmap_free(capture->requests_done);
 	kfree(capture);
 	chan->capture_data = NULL;
 }
@@ -712,6 +731,15 @@ int vi_capture_setup(
 		goto unpin_alloc_fail;
 	}
 
+	bitmap_free(capture->requests_done);
+	capture->requests_done = bitmap_zalloc(setup->queue_depth, GFP_KERNEL);
+	if (!capture->requests_done) {
+		dev_err(chan->dev,
+			"%s: request status ring alloc failed\n", __func__);
+		err = -ENOMEM;
+		goto done_alloc_fail;
+	}
+
 	config->requests_memoryinfo = capture->requests_memoryinfo_iova;
 	config->request_memoryinfo_size =
 			sizeof(struct capture_descriptor_memoryinfo);
@@ -800,6 +828,9 @@ int vi_capture_setup(
 cb_fail:
 resp_fail:
 submit_fail:
+	bitmap_free(capture->requests_done);
+	capture->requests_done = NULL;
+done_alloc_fail:
 	vfree(capture->unpins_list);
 	capture->unpins_list = NULL;
 unpin_alloc_fail:
@@ -893,6 +924,9 @@ int vi_capture_reset(
 		dev_err(chan->dev, "%s: control failed, errno %d", __func__,
 			resp_msg->channel_reset_resp.result);
 		err = -EINVAL;
+	} else if (capture->requests_done != NULL) {
+		/* pending requests were discarded, forget their completions */
+		bitmap_zero(capture->requests_done, capture->queue_depth);
 	}
 
 submit_fail:
@@ -929,6 +963,8 @@ int vi_capture_release(
 
 	}
 
+	vi_capture_set_status_notify(chan, NULL, NULL);
+
 	memset(&control_desc, 0, sizeof(control_desc));
 	control_desc.header.msg_id = CAPTURE_CHANNEL_RELEASE_REQ;
 	control_desc.header.channel_id = capture->channel_id;
@@ -974,6 +1010,7 @@ int vi_capture_release(
 
 	for (i = 0; i < capture->queue_depth; i++)
 		complete(&capture->capture_resp);
+	wake_up_all(&capture->status_wait);
 
 	vi_capture_release_syncpts(chan);
 
@@ -1381,6 +1418,11 @@ int vi_capture_request(
 
 	mutex_lock(&capture->reset_lock);
 
+	/* drop a stale completion of a previously timed out request */
+	if (capture->requests_done != NULL &&
+			req->buffer_index < capture->queue_depth)
+		clear_bit(req->buffer_index, capture->requests_done);
+
 	memset(&capture_desc, 0, sizeof(capture_desc));
 	capture_desc.header.msg_id = CAPTURE_REQUEST_REQ;
 	capture_desc.header.channel_id = capture->channel_id;
@@ -1460,6 +1502,82 @@ int vi_capture_status(
 }
 EXPORT_SYMBOL_GPL(vi_capture_status);
 
+bool vi_capture_status_done(
+	struct tegra_vi_channel *chan,
+	uint32_t buffer_index)
+{
+	struct vi_capture *capture = chan->capture_data;
+
+	if (capture == NULL || capture->requests_done == NULL ||
+			buffer_index >= capture->queue_depth)
+		return false;
+
+	return test_and_clear_bit(buffer_index, capture->requests_done);
+}
+EXPORT_SYMBOL_GPL(vi_capture_status_done);
+
+int vi_capture_status_wait(
+	struct tegra_vi_channel *chan,
+	uint32_t buffer_index,
+	int32_t timeout_ms)
+{
+	struct vi_capture *capture = chan->capture_data;
+	long ret;
+
+	if (capture == NULL) {
+		dev_err(chan->dev,
+			 "%s: vi capture uninitialized\n", __func__);
+		return -ENODEV;
+	}
+
+	if (capture->channel_id == CAPTURE_CHANNEL_INVALID_ID) {
+		dev_err(chan->dev,
+			"%s: setup channel first\n", __func__);
+		return -ENODEV;
+	}
+
+	if (vi_capture_status_done(chan, buffer_index))
+		return 0;
+
+	dev_dbg(chan->dev, "%s: waiting for buf:%u, timeout:%d ms\n",
+		__func__, buffer_index, timeout_ms);
+
+	/* negative timeout means wait forever */
+	ret = wait_event_timeout(capture->status_wait,
+			vi_capture_status_done(chan, buffer_index) ||
+			capture->channel_id == CAPTURE_CHANNEL_INVALID_ID,
+			timeout_ms < 0 ? MAX_SCHEDULE_TIMEOUT :
+					msecs_to_jiffies(timeout_ms));
+	if (ret == 0) {
+		dev_dbg(chan->dev,
+			"capture status timed out\n");
+		return -ETIMEDOUT;
+	}
+
+	if (capture->channel_id == CAPTURE_CHANNEL_INVALID_ID)
+		return -ENODEV;
+
+	return 0;
+}
+EXPORT_SYMBOL_GPL(vi_capture_status_wait);
+
+void vi_capture_set_status_notify(
+	struct tegra_vi_channel *chan,
+	void (*notify)(void *data, uint32_t buffer_index),
+	void *data)
+{
+	struct vi_capture *capture = chan->capture_data;
+
+	if (capture == NULL)
+		return;
+
+	spin_lock(&capture->notify_lock);
+	capture->status_notify = notify;
+	capture->status_notify_data = data;
+	spin_unlock(&capture->notify_lock);
+}
+EXPORT_SYMBOL_GPL(vi_capture_set_status_notify);
+
 int vi_capture_set_progress_status_notifier(
 	struct tegra_vi_channel *chan,
 	struct vi_capture_progress_status_req *req)
@@ -142,6 +142,12 @@ int tegracam_device_register(struct tegracam_device *tc_dev)
 	/*TODO: compile frmfmt array from DT */
 	s_data->frmfmt = tc_dev->sensor_ops->frmfmt_table;
 	s_data->numfmts = tc_dev->sensor_ops->numfrmfmts;
+	err = camera_common_build_fmt_index(s_data);
+	if (err) {
+		dev_err(dev, "unable to index frame formats\n");
+		camera_common_cleanup(s_data);
+		return err;
+	}
 	sensor_mode = &s_data->sensor_props.sensor_modes[mode_idx];
 	signal_props = &sensor_mode->signal_properties;
 	image_props = &sensor_mode->image_properties;
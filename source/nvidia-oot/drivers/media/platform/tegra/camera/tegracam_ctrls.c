@@ -571,6 +571,27 @@ static int tegracam_set_ctrls_ex(struct tegracam_ctrl_handler *handler,
 	struct tegracam_sensor_data *sensor_data = &handler->sensor_data;
 	struct sensor_blob *blob = &sensor_data->ctrls_blob;
 	int err = 0;
+	u32 status = 0;
+
+	switch (ctrl->id) {
+	case TEGRA_CAMERA_CID_GAIN:
+	case TEGRA_CAMERA_CID_FRAME_RATE:
+	case TEGRA_CAMERA_CID_EXPOSURE:
+		/*
+		 * blob setters may fall back to direct register writes,
+		 * so skip them like tegracam_set_ctrls while powered off.
+		 * The values are applied by the overrides at stream on.
+		 */
+		if (v4l2_subdev_call(&s_data->subdev, video,
+					g_input_status, &status)) {
+			dev_err(s_data->dev, "power status query unsupported\n");
+			return -ENOTTY;
+		}
+
+		if (!status)
+			return 0;
+		break;
+	}
 
 	switch (ctrl->id) {
 	case TEGRA_CAMERA_CID_GAIN:
@@ -591,8 +612,8 @@ static int tegracam_set_ctrls_ex(struct tegracam_ctrl_handler *handler,
 	case TEGRA_CAMERA_CID_HDR_EN:
 		break;
 	default:
-		pr_err("%s: unknown ctrl id.\n", __func__);
-		return -EINVAL;
+		/* controls without a blob variant are written directly */
+		return tegracam_set_ctrls(handler, ctrl);
 	}
 
 	return err;
@@ -1330,6 +1351,8 @@ int tegracam_ctrl_handler_init(struct tegracam_ctrl_handler *handler)
 	spec_bar();
 
 	handler->numctrls = numctrls;
+	/* setters run by the handler setup look controls up by CID */
+	tegracam_ctrl_build_index(handler);
 	err = v4l2_ctrl_handler_setup(&handler->ctrl_handler);
 	if (err) {
 		dev_err(dev, "Error %d in control hdl setup\n", err);
@@ -1366,3 +1389,51 @@ ctrl_error:
 	return err;
 }
 EXPORT_SYMBOL_GPL(tegracam_ctrl_handler_init);
+
+/*
+ * Map the registered controls by their offset from TEGRA_CAMERA_CID_BASE.
+ * Built before the framework controls are set up and rebuilt once the
+ * private controls have been added.
+ */
+void tegracam_ctrl_build_index(struct tegracam_ctrl_handler *handler)
+{
+	struct v4l2_ctrl *ctrl;
+	u32 offset;
+	int i;
+
+	memset(handler->cid_index, 0, sizeof(handler->cid_index));
+
+	for (i = 0; i < handler->numctrls; i++) {
+		ctrl = handler->ctrls[i];
+		if (ctrl == NULL || ctrl->id < TEGRA_CAMERA_CID_BASE)
+			continue;
+
+		offset = ctrl->id - TEGRA_CAMERA_CID_BASE;
+		if (offset < TEGRACAM_CID_INDEX_SIZE)
+			handler->cid_index[offset] = i + 1;
+	}
+}
+EXPORT_SYMBOL_GPL(tegracam_ctrl_build_index);
+
+struct v4l2_ctrl *tegracam_find_ctrl(struct tegracam_ctrl_handler *handler,
+		u32 cid)
+{
+	struct v4l2_ctrl *ctrl;
+	u32 offset = cid - TEGRA_CAMERA_CID_BASE;
+	int i;
+
+	if (cid >= TEGRA_CAMERA_CID_BASE && offset < TEGRACAM_CID_INDEX_SIZE) {
+		i = handler->cid_index[offset];
+		return i ? handler->ctrls[i - 1] : NULL;
+	}
+
+	/* sensor specific control classes are not indexed */
+	for (i = 0; i < handler->numctrls; i++) {
+		ctrl = handler->ctrls[i];
+		if (ctrl && ctrl->id == cid)
+			return ctrl;
+	}
+
+	return NULL;
+}
+EXPORT_SYMBOL_GPL(tegracam_find_ctrl);
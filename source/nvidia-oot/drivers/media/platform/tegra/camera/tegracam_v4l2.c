@@ -216,6 +216,7 @@ int tegracam_v4l2subdev_register(struct tegracam_device *tc_dev,
 		    return err;
 	    }
 	}
+	tegracam_ctrl_build_index(ctrl_hdl);
 	if (ctrl_hdl->ctrl_ops != NULL)
 		tc_dev->numctrls = ctrl_hdl->ctrl_ops->numctrls;
 	else
@@ -7,6 +7,7 @@
 #include <linux/atomic.h>
 #include <linux/bitmap.h>
 #include <linux/clk.h>
+#include <linux/debugfs.h>
 #include <linux/delay.h>
 #include <linux/nvhost.h>
 #include <linux/lcm.h>
@@ -17,6 +18,7 @@
 #include <linux/sched.h>
 #include <linux/slab.h>
 #include <linux/semaphore.h>
+#include <linux/seq_file.h>
 #include <linux/arm64-barrier.h>
 #include <media/v4l2-ctrls.h>
 #include <media/v4l2-event.h>
@@ -622,21 +624,33 @@ done:
 }
 EXPORT_SYMBOL(dequeue_buffer);
 
-struct tegra_channel_buffer *dequeue_dequeue_buffer(struct tegra_channel *chan)
+/*
+ * The dequeue ring has a single producer, the capture enqueue thread, and a
+ * single consumer, the capture dequeue thread, so it needs no lock. It holds
+ * every capture buffer, a put can't fail.
+ */
+void enqueue_dequeue_buffer(struct tegra_channel *chan,
+	struct tegra_channel_buffer *buf)
 {
-	struct tegra_channel_buffer *buf = NULL;
+	kfifo_put(&chan->dequeue, buf);
 
-	spin_lock(&chan->dequeue_lock);
+	/*
+	 * wq_has_sleeper() orders the put before the waiter check, pairing
+	 * with the barrier the consumer takes before testing the ring in
+	 * wait_event, so a consumer going to sleep always sees the entry.
+	 */
+	if (wq_has_sleeper(&chan->dequeue_wait))
+		wake_up_interruptible(&chan->dequeue_wait);
+}
+EXPORT_SYMBOL(enqueue_dequeue_buffer);
 
-	if (list_empty(&chan->dequeue))
-		goto done;
+struct tegra_channel_buffer *dequeue_dequeue_buffer(struct tegra_channel *chan)
+{
+	struct tegra_channel_buffer *buf = NULL;
 
-	buf = list_entry(chan->dequeue.next, struct tegra_channel_buffer,
-		queue);
-	list_del_init(&buf->queue);
+	if (!kfifo_get(&chan->dequeue, &buf))
+		return NULL;
 
-done:
-	spin_unlock(&chan->dequeue_lock);
 	return buf;
 }
 EXPORT_SYMBOL(dequeue_dequeue_buffer);
@@ -663,6 +677,44 @@ done:
 }
 EXPORT_SYMBOL(tegra_channel_error_recover);
 
+void tegra_channel_stats_latency(struct tegra_channel *chan,
+	enum tegra_channel_latency type, s64 ns)
+{
+	unsigned int bucket = 0;
+
+	if (ns > 0)
+		bucket = min_t(unsigned int, fls64(div_u64(ns, NSEC_PER_USEC)),
+				TEGRA_LATENCY_BUCKETS - 1);
+
+	spin_lock(&chan->stats_lock);
+	chan->stats.hist[type][bucket]++;
+	spin_unlock(&chan->stats_lock);
+}
+EXPORT_SYMBOL(tegra_channel_stats_latency);
+
+/*
+ * The descriptor frame id is 16 bit and its range depends on the sensor.
+ * Gaps are taken modulo 16 bits. An id that does not advance or moves
+ * back by more than half the range is a sensor without frame numbering
+ * or one that wraps early, and is not counted as a drop.
+ */
+void tegra_channel_stats_frame(struct tegra_channel *chan, u32 frame_id)
+{
+	struct tegra_channel_stats *stats = &chan->stats;
+	u16 gap;
+
+	spin_lock(&chan->stats_lock);
+	gap = frame_id - stats->last_frame_id - 1;
+	if (stats->frame_id_valid && frame_id != stats->last_frame_id &&
+		gap < BIT(15))
+		stats->drops += gap;
+
+	stats->last_frame_id = frame_id;
+	stats->frame_id_valid = true;
+	spin_unlock(&chan->stats_lock);
+}
+EXPORT_SYMBOL(tegra_channel_stats_frame);
+
 static struct device *tegra_channel_get_vi_unit(struct tegra_channel *chan)
 {
 	struct tegra_mc_vi *vi = chan->vi;
@@ -798,13 +850,9 @@ static void tegra_channel_queued_buf_done_single_thread(
 	}
 	spin_unlock(&chan->start_lock);
 
-	/* delete dequeue list */
-	spin_lock(&chan->dequeue_lock);
-	list_for_each_entry_safe(buf, nbuf, &chan->dequeue, queue) {
+	/* drain dequeue ring, both of its threads are stopped */
+	while ((buf = dequeue_dequeue_buffer(chan)) != NULL)
 		vb2_buffer_done(&buf->buf.vb2_buf, state);
-		list_del(&buf->queue);
-	}
-	spin_unlock(&chan->dequeue_lock);
 }
 
 static void tegra_channel_queued_buf_done_multi_thread(
@@ -2158,6 +2206,12 @@ tegra_channel_set_format(struct file *file, void *fh,
 	if (vb2_is_busy(&chan->queue))
 		return -EBUSY;
 
+	/* queue depth learned for another format does not apply */
+	if (format->fmt.pix.width != chan->format.width ||
+		format->fmt.pix.height != chan->format.height ||
+		format->fmt.pix.pixelformat != chan->format.pixelformat)
+		chan->capture_depth_hint = 0;
+
 	return __tegra_channel_set_format(chan, &format->fmt.pix);
 }
 
@@ -2167,6 +2221,9 @@ static int tegra_channel_subscribe_event(struct v4l2_fh *fh,
 	switch (sub->type) {
 	case V4L2_EVENT_SOURCE_CHANGE:
 		return v4l2_event_subscribe(fh, sub, 4, NULL);
+	case TEGRA_CAMERA_EVENT_FRAME_DONE:
+		/* oldest completions are dropped if the reader falls behind */
+		return v4l2_event_subscribe(fh, sub, 16, NULL);
 	}
 	return v4l2_ctrl_subscribe_event(fh, sub);
 }
@@ -2552,6 +2609,99 @@ ctrl_init_error:
 }
 EXPORT_SYMBOL(tegra_channel_init_video);
 
+static int tegra_channel_stats_show(struct seq_file *s, void *unused)
+{
+	struct tegra_channel *chan = s->private;
+	struct tegra_channel_stats *stats;
+	int i;
+
+	stats = kmalloc(sizeof(*stats), GFP_KERNEL);
+	if (!stats)
+		return -ENOMEM;
+
+	spin_lock(&chan->stats_lock);
+	*stats = chan->stats;
+	spin_unlock(&chan->stats_lock);
+
+	seq_puts(s, "us\tsof-eof\teof-dq\tdq-done\n");
+	for (i = 0; i < TEGRA_LATENCY_BUCKETS; i++) {
+		if (i < TEGRA_LATENCY_BUCKETS - 1)
+			seq_printf(s, "<%lu", BIT(i));
+		else
+			seq_printf(s, ">=%lu", BIT(i - 1));
+		seq_printf(s, "\t%u\t%u\t%u\n",
+			stats->hist[TEGRA_LATENCY_SOF_EOF][i],
+			stats->hist[TEGRA_LATENCY_EOF_DEQUEUE][i],
+			stats->hist[TEGRA_LATENCY_DEQUEUE_DONE][i]);
+	}
+	seq_printf(s, "drops\t%u\n", stats->drops);
+	seq_printf(s, "errors\t%u\n", stats->errors);
+	kfree(stats);
+
+	return 0;
+}
+
+static int tegra_channel_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, tegra_channel_stats_show, inode->i_private);
+}
+
+/* any write resets the statistics */
+static ssize_t tegra_channel_stats_write(struct file *file,
+	const char __user *buf, size_t count, loff_t *offp)
+{
+	struct seq_file *s = file->private_data;
+	struct tegra_channel *chan = s->private;
+	struct tegra_channel_stats *stats = &chan->stats;
+
+	/* the frame id sequence of a running stream is kept */
+	spin_lock(&chan->stats_lock);
+	memset(stats->hist, 0, sizeof(stats->hist));
+	stats->drops = 0;
+	stats->errors = 0;
+	spin_unlock(&chan->stats_lock);
+
+	return count;
+}
+
+static const struct file_operations tegra_channel_stats_fops = {
+	.open		= tegra_channel_stats_open,
+	.read		= seq_read,
+	.write		= tegra_channel_stats_write,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+static void tegra_channel_create_debugfs(struct tegra_channel *chan)
+{
+	char name[32];
+
+	snprintf(name, sizeof(name), "%s-chan%u", dev_name(chan->vi->dev),
+		chan->id);
+	chan->debugdir = debugfs_create_dir(name, NULL);
+	if (IS_ERR_OR_NULL(chan->debugdir)) {
+		chan->debugdir = NULL;
+		return;
+	}
+
+	debugfs_create_u32("recover_fast", 0644, chan->debugdir,
+			&chan->fast_recoveries);
+	debugfs_create_u32("recover_full", 0644, chan->debugdir,
+			&chan->full_recoveries);
+	debugfs_create_file("latency", 0644, chan->debugdir, chan,
+			&tegra_channel_stats_fops);
+	debugfs_create_u32("sync_matched", 0644, chan->debugdir,
+			&chan->sync_matched);
+	debugfs_create_u32("sync_unmatched", 0644, chan->debugdir,
+			&chan->sync_unmatched);
+	debugfs_create_u32("sync_drift_us", 0444, chan->debugdir,
+			&chan->sync_drift_us);
+	debugfs_create_u32("sync_drift_max_us", 0644, chan->debugdir,
+			&chan->sync_drift_max_us);
+	debugfs_create_u32("queue_depth_hint", 0644, chan->debugdir,
+			&chan->capture_depth_hint);
+}
+
 int tegra_channel_init(struct tegra_channel *chan)
 {
 	int ret;
@@ -2585,14 +2735,15 @@ int tegra_channel_init(struct tegra_channel *chan)
 	chan->capture_version = 0;
 	spin_lock_init(&chan->start_lock);
 	spin_lock_init(&chan->release_lock);
-	INIT_LIST_HEAD(&chan->dequeue);
+	INIT_KFIFO(chan->dequeue);
+	INIT_LIST_HEAD(&chan->sync_entry);
 	init_waitqueue_head(&chan->dequeue_wait);
-	spin_lock_init(&chan->dequeue_lock);
 	mutex_init(&chan->stop_kthread_lock);
 	init_rwsem(&chan->reset_lock);
 	atomic_set(&chan->is_streaming, DISABLE);
 	spin_lock_init(&chan->capture_state_lock);
 	spin_lock_init(&chan->buffer_lock);
+	spin_lock_init(&chan->stats_lock);
 
 	/* Init video format */
 	vi->fops->vi_init_video_formats(chan);
@@ -2640,6 +2791,8 @@ int tegra_channel_init(struct tegra_channel *chan)
 		goto deskew_ctx_err;
 	}
 
+	tegra_channel_create_debugfs(chan);
+
 	chan->init_done = true;
 
 	return 0;
@@ -2680,6 +2833,9 @@ int tegra_channel_cleanup(struct tegra_channel *chan)
 
 	tegra_channel_dealloc_buffer_queue(chan);
 
+	debugfs_remove_recursive(chan->debugdir);
+	chan->debugdir = NULL;
+
 	v4l2_ctrl_handler_free(&chan->ctrl_handler);
 	mutex_lock(&chan->video_lock);
 	vb2_queue_release(&chan->queue);
@@ -9,15 +9,20 @@
 #include <linux/freezer.h>
 #include <linux/fs.h>
 #include <linux/kthread.h>
+#include <linux/math64.h>
+#include <linux/module.h>
 #include <linux/nvhost.h>
 #include <linux/pm_runtime.h>
 #include <linux/semaphore.h>
+#include <linux/slab.h>
 #include <linux/syscalls.h>
+#include <asm/arch_timer.h>
 #include <media/fusa-capture/capture-vi-channel.h>
 #include <media/fusa-capture/capture-vi.h>
 #include <media/mc_common.h>
 #include <media/tegra-v4l2-camera.h>
 #include <media/tegra_camera_platform.h>
+#include <media/v4l2-event.h>
 #include <soc/tegra/camrtc-capture.h>
 #include <media/vi.h>
 #include <trace/events/camera_common.h>
@@ -36,6 +41,40 @@
 
 #define CAPTURE_TIMEOUT_MS	2500
 
+/* Buffers added to the queue depth hint after a starved stream */
+#define CAPTURE_DEPTH_STEP	2U
+/* A stream is starved with this many dry frames, at least 1 in RATIO */
+#define CAPTURE_STARVED_MIN	8U
+#define CAPTURE_STARVED_RATIO	32U
+/* In place resets without a good frame before a full recovery */
+#define CAPTURE_FAST_RECOVER_MAX	3U
+
+static unsigned int sync_window_us = 1000;
+module_param(sync_window_us, uint, 0644);
+MODULE_PARM_DESC(sync_window_us,
+	"Largest SOF spread of frames released together by a VI sync group [us]");
+
+/*
+ * Sync group with streaming members, the lock guards the member frames.
+ * completing counts releases which are handing frames to vb2 unlocked.
+ */
+struct tegra_channel_sync_group {
+	struct list_head entry;
+	struct list_head channels;
+	spinlock_t lock;
+	atomic_t completing;
+	wait_queue_head_t wait;
+	unsigned int id;
+};
+
+static DEFINE_MUTEX(vi5_sync_groups_lock);
+static LIST_HEAD(vi5_sync_groups);
+
+static unsigned int capture_queue_depth;
+module_param(capture_queue_depth, uint, 0644);
+MODULE_PARM_DESC(capture_queue_depth,
+	"Minimum number of capture buffers and descriptors per channel");
+
 static const struct vi_capture_setup default_setup = {
 	.channel_flags = 0
 	| CAPTURE_CHANNEL_FLAG_VIDEO
@@ -135,6 +174,11 @@ static int tegra_vi5_s_ctrl(struct v4l2_ctrl *ctrl)
 	case TEGRA_CAMERA_CID_WRITE_ISPFORMAT:
 		chan->write_ispformat = ctrl->val;
 		break;
+	case TEGRA_CAMERA_CID_VI_SYNC_GROUP:
+		if (vb2_is_streaming(&chan->queue))
+			return -EBUSY;
+		chan->sync_group = ctrl->val;
+		break;
 	default:
 		dev_err(&chan->video->dev, "%s:Not valid ctrl\n", __func__);
 		return -EINVAL;
@@ -201,6 +245,16 @@ static const struct v4l2_ctrl_config vi5_custom_ctrls[] = {
 		.step = 1,
 		.dims = { SENSOR_CTRL_BLOB_SIZE },
 	},
+	{
+		.ops = &vi5_ctrl_ops,
+		.id = TEGRA_CAMERA_CID_VI_SYNC_GROUP,
+		.name = "VI sync group",
+		.type = V4L2_CTRL_TYPE_INTEGER,
+		.def = 0,
+		.min = 0,
+		.max = 255,
+		.step = 1,
+	},
 };
 
 static int vi5_add_ctrls(struct tegra_channel *chan)
@@ -271,6 +325,13 @@ static int vi5_channel_setup_queue(struct tegra_channel *chan,
 {
 	int ret = 0;
 
+	/* vb2 allocates as many buffers as the queue depth returned here */
+	if (*nbuffers < max(capture_queue_depth, chan->capture_depth_hint))
+		dev_dbg(&chan->video->dev,
+			"raising %u requested buffers to queue depth %u/%u\n",
+			*nbuffers, capture_queue_depth,
+			chan->capture_depth_hint);
+	*nbuffers = max3(*nbuffers, capture_queue_depth, chan->capture_depth_hint);
 	*nbuffers = clamp(*nbuffers, CAPTURE_MIN_BUFFERS, CAPTURE_MAX_BUFFERS);
 
 	ret = tegra_channel_alloc_buffer_queue(chan, *nbuffers);
@@ -308,6 +369,88 @@ static struct tegra_csi_channel *find_linked_csi_channel(
 	return csi_chan;
 }
 
+/*
+ * Build every descriptor slot of the capture queue once per stream. Only the
+ * surface addresses and the sequence number change between frames, those are
+ * patched by vi5_setup_surface() when a buffer is enqueued.
+ */
+static void vi5_init_descriptors(struct tegra_channel *chan, unsigned int vi_port)
+{
+	u32 height = chan->format.height;
+	u32 width = chan->format.width;
+	u32 bpl = chan->format.bytesperline;
+	u32 nvcsi_stream = chan->port[vi_port];
+	struct capture_descriptor_memoryinfo *desc_memoryinfo;
+	struct capture_descriptor *desc;
+	unsigned int descr_index;
+
+	if (chan->valid_ports > NVCSI_STREAM_1) {
+		height = chan->gang_height;
+		width = chan->gang_width;
+	}
+
+	for (descr_index = 0; descr_index < chan->capture_queue_depth;
+			descr_index++) {
+		desc = &chan->request[vi_port][descr_index];
+		desc_memoryinfo = &chan->tegra_vi_channel[vi_port]->
+			capture_data->requests_memoryinfo[descr_index];
+
+		memcpy(desc, &capture_template, sizeof(capture_template));
+		memset(desc_memoryinfo, 0, sizeof(*desc_memoryinfo));
+
+		desc->ch_cfg.match.stream = (1u << nvcsi_stream); /* one-hot bit encoding */
+		desc->ch_cfg.match.vc = (1u << chan->virtual_channel); /* one-hot bit encoding */
+		desc->ch_cfg.frame.frame_x = width;
+		desc->ch_cfg.frame.frame_y = height;
+		desc->ch_cfg.match.datatype = chan->fmtinfo->img_dt;
+		desc->ch_cfg.match.datatype_mask = 0x3f;
+		desc->ch_cfg.pixfmt_enable = 1;
+		desc->ch_cfg.pixfmt.format = chan->fmtinfo->img_fmt;
+
+		desc_memoryinfo->surface[0].size = chan->format.bytesperline * height;
+		desc->ch_cfg.atomp.surface_stride[0] = bpl;
+		if (chan->fmtinfo->fourcc == V4L2_PIX_FMT_NV16) {
+			desc_memoryinfo->surface[1].size = chan->format.bytesperline * height;
+			desc->ch_cfg.atomp.surface_stride[1] = bpl;
+		}
+
+		if (chan->embedded_data_height > 0) {
+			desc->ch_cfg.embdata_enable = 1;
+			desc->ch_cfg.frame.embed_x = chan->embedded_data_width * BPP_MEM;
+			desc->ch_cfg.frame.embed_y = chan->embedded_data_height;
+
+			desc_memoryinfo->surface[VI_ATOMP_SURFACE_EMBEDDED].size
+				= desc->ch_cfg.frame.embed_x * desc->ch_cfg.frame.embed_y;
+
+			desc->ch_cfg.atomp.surface_stride[VI_ATOMP_SURFACE_EMBEDDED]
+				= chan->embedded_data_width * BPP_MEM;
+		}
+	}
+}
+
+/* Runs in the IVC receive context, ahead of the dequeue thread */
+static void vi5_capture_status_notify(void *data, uint32_t index)
+{
+	struct tegra_channel *chan = data;
+	struct capture_descriptor *descr = &chan->request[0][index];
+	struct tegra_camera_frame_done *done;
+	struct v4l2_event ev = {
+		.type = TEGRA_CAMERA_EVENT_FRAME_DONE,
+	};
+
+	done = (struct tegra_camera_frame_done *)ev.u.data;
+	done->index = chan->request_vb2_index[index];
+	done->sequence = descr->sequence;
+	done->frame_id = descr->status.frame_id;
+	done->status = descr->status.status;
+	done->sof_timestamp = descr->status.sof_timestamp;
+	done->eof_timestamp = descr->status.eof_timestamp;
+	done->flags = descr->status.flags;
+	done->err_data = descr->status.err_data;
+
+	v4l2_event_queue(chan->video, &ev);
+}
+
 static int tegra_channel_capture_setup(struct tegra_channel *chan, unsigned int vi_port)
 {
 	struct vi_capture_setup setup = default_setup;
@@ -363,104 +506,68 @@ static int tegra_channel_capture_setup(struct tegra_channel *chan, unsigned int
 		return err;
 	}
 
+	vi5_init_descriptors(chan, vi_port);
+
+	/* A ganged frame is only complete once every port is done */
+	if (chan->valid_ports == 1)
+		vi_capture_set_status_notify(chan->tegra_vi_channel[vi_port],
+				vi5_capture_status_notify, chan);
+
 	return 0;
 }
 
-/* XXX originally defined in kernel-4.9/drivers/media/v4l2-core/videobuf2-dma-contig.c
-   This struct is private, so it is redefined here to be able to access the virtual address of the buffer.
-*/
-struct vb2_dc_buf {
-    struct device            *dev;
-    void                *vaddr;
-    unsigned long            size;
-    void                *cookie;
-    dma_addr_t            dma_addr;
-    unsigned long            attrs;
-    enum dma_data_direction        dma_dir;
-    struct sg_table            *dma_sgt;
-    struct frame_vector        *vec;
-#if 0
-    /* MMAP related */
-    struct vb2_vmarea_handler    handler;
-    atomic_t            refcount;
-    struct sg_table            *sgt_base;
-
-    /* DMABUF related */
-    struct dma_buf_attachment    *db_attach;
-#endif
-};
-
 static void vi5_setup_surface(struct tegra_channel *chan,
 	struct tegra_channel_buffer *buf, unsigned int descr_index, unsigned int vi_port)
 {
 	dma_addr_t offset = buf->addr + chan->buffer_offset[vi_port];
-	u32 height = chan->format.height;
-	u32 width = chan->format.width;
-	u32 format = chan->fmtinfo->img_fmt;
-	u32 bpl = chan->format.bytesperline;
-	u32 data_type = chan->fmtinfo->img_dt;
-	u32 nvcsi_stream = chan->port[vi_port];
 	struct capture_descriptor_memoryinfo *desc_memoryinfo =
 		&chan->tegra_vi_channel[vi_port]->
 		capture_data->requests_memoryinfo[descr_index];
 	struct capture_descriptor *desc = &chan->request[vi_port][descr_index];
 
 	dma_addr_t embedded_data_buf = buf->addr + chan->buffer_offset[vi_port] + chan->format.sizeimage + EMBEDDED_DATA_BUFFER_ZONE_SIZE; // add 8 bytes of space for storing info about embedded data
-	struct vb2_dc_buf* buf_priv = (struct vb2_dc_buf*)buf->buf.vb2_buf.planes[vi_port].mem_priv;
-	uint16_t * ptr_to_embedded_data = (uint16_t *)buf_priv->vaddr;
+	uint16_t *ptr_to_embedded_data;
 	uint32_t end_of_image_offset_words = (chan->buffer_offset[vi_port] + chan->format.sizeimage) / 2;
 
-	if (chan->valid_ports > NVCSI_STREAM_1) {
-		height = chan->gang_height;
-		width = chan->gang_width;
+	if (chan->valid_ports > NVCSI_STREAM_1)
 		offset = buf->addr + chan->buffer_offset[1 - vi_port];
-	}
-
-	memcpy(desc, &capture_template, sizeof(capture_template));
-	memset(desc_memoryinfo, 0, sizeof(*desc_memoryinfo));
 
 	desc->sequence = chan->capture_descr_sequence;
-	desc->ch_cfg.match.stream = (1u << nvcsi_stream); /* one-hot bit encoding */
-	desc->ch_cfg.match.vc = (1u << chan->virtual_channel); /* one-hot bit encoding */
-	desc->ch_cfg.frame.frame_x = width;
-	desc->ch_cfg.frame.frame_y = height;
-	desc->ch_cfg.match.datatype = data_type;
-	desc->ch_cfg.match.datatype_mask = 0x3f;
-	desc->ch_cfg.pixfmt_enable = 1;
-	desc->ch_cfg.pixfmt.format = format;
+	memset(&desc->status, 0, sizeof(desc->status));
 
 	desc_memoryinfo->surface[0].base_address = offset;
-	desc_memoryinfo->surface[0].size = chan->format.bytesperline * height;
-	desc->ch_cfg.atomp.surface_stride[0] = bpl;
-	if (chan->fmtinfo->fourcc == V4L2_PIX_FMT_NV16) {
+	if (chan->fmtinfo->fourcc == V4L2_PIX_FMT_NV16)
 		desc_memoryinfo->surface[1].base_address = offset + chan->format.sizeimage / 2;
-		desc_memoryinfo->surface[1].size = chan->format.bytesperline * height;
-		desc->ch_cfg.atomp.surface_stride[1] = bpl;
-	}
-
-	if (chan->embedded_data_height > 0) {
-		desc->ch_cfg.embdata_enable = 1;
-		desc->ch_cfg.frame.embed_x = chan->embedded_data_width * BPP_MEM;
-		desc->ch_cfg.frame.embed_y = chan->embedded_data_height;
 
+	if (chan->embedded_data_height > 0)
 		desc_memoryinfo->surface[VI_ATOMP_SURFACE_EMBEDDED].base_address
 			= embedded_data_buf;
-		desc_memoryinfo->surface[VI_ATOMP_SURFACE_EMBEDDED].size
-			= desc->ch_cfg.frame.embed_x * desc->ch_cfg.frame.embed_y;
 
-		desc->ch_cfg.atomp.surface_stride[VI_ATOMP_SURFACE_EMBEDDED]
-			= chan->embedded_data_width * BPP_MEM;
+	/*
+	 * The embedded data size header sits in the zone between the image and
+	 * the embedded data, which VI never writes. It only has to be stored
+	 * once per buffer memory and stream. DMABUF and USERPTR memory can
+	 * change behind an unchanged IOVA, so those are written every time.
+	 */
+	if (buf->buf.vb2_buf.memory != VB2_MEMORY_MMAP ||
+			buf->emb_hdr_version != chan->emb_hdr_version ||
+			buf->emb_hdr_addr != buf->addr) {
+		ptr_to_embedded_data = vb2_plane_vaddr(&buf->buf.vb2_buf, 0);
+		if (ptr_to_embedded_data) {
+			ptr_to_embedded_data[end_of_image_offset_words] = chan->embedded_data_width;
+			ptr_to_embedded_data[end_of_image_offset_words + 1] = chan->embedded_data_height;
+		}
 	}
 
-	ptr_to_embedded_data[end_of_image_offset_words] = chan->embedded_data_width;
-	ptr_to_embedded_data[end_of_image_offset_words + 1] = chan->embedded_data_height;
-
 	//capture sequence should increment for each vi channel
-	if ((chan->valid_ports - vi_port) == 1)
+	if ((chan->valid_ports - vi_port) == 1) {
 		chan->capture_descr_sequence += 1;
+		buf->emb_hdr_version = chan->emb_hdr_version;
+		buf->emb_hdr_addr = buf->addr;
+	}
 }
 
-static void vi5_release_buffer(struct tegra_channel *chan,
+static void vi5_prepare_buffer(struct tegra_channel *chan,
 	struct tegra_channel_buffer *buf)
 {
 	struct vb2_v4l2_buffer *vbuf = &buf->buf;
@@ -468,8 +575,185 @@ static void vi5_release_buffer(struct tegra_channel *chan,
 	vbuf->sequence = chan->sequence++;
 	vbuf->field = V4L2_FIELD_NONE;
 	vb2_set_plane_payload(&vbuf->vb2_buf, 0, chan->format.sizeimage);
+}
+
+static void vi5_buffer_done(struct tegra_channel *chan,
+	struct tegra_channel_buffer *buf)
+{
+	u64 dequeue_ns = buf->dequeue_ns;
+
+	buf->dequeue_ns = 0;
+	vb2_buffer_done(&buf->buf.vb2_buf, buf->vb2_state);
+
+	/* frames held for a sync group are timed until their release */
+	if (dequeue_ns)
+		tegra_channel_stats_latency(chan, TEGRA_LATENCY_DEQUEUE_DONE,
+			ktime_get_ns() - dequeue_ns);
+}
+
+static void vi5_release_buffer(struct tegra_channel *chan,
+	struct tegra_channel_buffer *buf)
+{
+	vi5_prepare_buffer(chan, buf);
+	vi5_buffer_done(chan, buf);
+}
+
+/*
+ * Frames of a sync group are numbered under the group lock and handed to
+ * vb2 once it is dropped, vb2_buffer_done() wakes the waiters of every
+ * member channel.
+ */
+static void vi5_sync_collect(struct tegra_channel *chan,
+	struct tegra_channel_buffer *buf, struct list_head *done)
+{
+	vi5_prepare_buffer(chan, buf);
+	list_add_tail(&buf->queue, done);
+}
+
+static void vi5_sync_complete(struct list_head *done)
+{
+	struct tegra_channel_buffer *buf, *tmp;
+
+	list_for_each_entry_safe(buf, tmp, done, queue) {
+		list_del_init(&buf->queue);
+		vi5_buffer_done(buf->chan, buf);
+	}
+}
+
+static int vi5_sync_join(struct tegra_channel *chan)
+{
+	struct tegra_channel_sync_group *grp;
+
+	if (!chan->sync_group)
+		return 0;
 
-	vb2_buffer_done(&vbuf->vb2_buf, buf->vb2_state);
+	mutex_lock(&vi5_sync_groups_lock);
+	list_for_each_entry(grp, &vi5_sync_groups, entry)
+		if (grp->id == chan->sync_group)
+			goto join;
+
+	grp = kzalloc(sizeof(*grp), GFP_KERNEL);
+	if (!grp) {
+		mutex_unlock(&vi5_sync_groups_lock);
+		return -ENOMEM;
+	}
+	grp->id = chan->sync_group;
+	INIT_LIST_HEAD(&grp->channels);
+	spin_lock_init(&grp->lock);
+	init_waitqueue_head(&grp->wait);
+	list_add_tail(&grp->entry, &vi5_sync_groups);
+
+join:
+	spin_lock(&grp->lock);
+	chan->sync_buf = NULL;
+	chan->sync_grp = grp;
+	list_add_tail(&chan->sync_entry, &grp->channels);
+	spin_unlock(&grp->lock);
+	mutex_unlock(&vi5_sync_groups_lock);
+
+	return 0;
+}
+
+static void vi5_sync_leave(struct tegra_channel *chan)
+{
+	struct tegra_channel_sync_group *grp = chan->sync_grp;
+	struct tegra_channel_buffer *buf;
+	bool empty;
+
+	if (!grp)
+		return;
+
+	mutex_lock(&vi5_sync_groups_lock);
+	spin_lock(&grp->lock);
+	list_del_init(&chan->sync_entry);
+	buf = chan->sync_buf;
+	chan->sync_buf = NULL;
+	if (buf) {
+		vi5_prepare_buffer(chan, buf);
+		chan->sync_unmatched++;
+	}
+	empty = list_empty(&grp->channels);
+	spin_unlock(&grp->lock);
+
+	/* a partner may still be completing a frame of this channel */
+	wait_event(grp->wait, !atomic_read(&grp->completing));
+
+	chan->sync_grp = NULL;
+	if (empty) {
+		list_del(&grp->entry);
+		kfree(grp);
+	}
+	mutex_unlock(&vi5_sync_groups_lock);
+
+	if (buf)
+		vi5_buffer_done(chan, buf);
+}
+
+/*
+ * Hold a captured frame until every streaming channel of the sync group has
+ * one, then release them together if their SOFs are within sync_window_us.
+ * Otherwise the oldest frame of the set can't be matched anymore and is
+ * released alone.
+ */
+static void vi5_sync_release(struct tegra_channel *chan,
+	struct tegra_channel_buffer *buf)
+{
+	struct tegra_channel_sync_group *grp = chan->sync_grp;
+	struct tegra_channel *it, *oldest = NULL;
+	u64 sof, sof_min = U64_MAX, sof_max = 0;
+	u32 drift_us;
+	LIST_HEAD(done);
+
+	spin_lock(&grp->lock);
+
+	/* the partners of a frame still held skipped it */
+	if (chan->sync_buf) {
+		vi5_sync_collect(chan, chan->sync_buf, &done);
+		chan->sync_buf = NULL;
+		chan->sync_unmatched++;
+	}
+
+	if (buf->vb2_state != VB2_BUF_STATE_DONE) {
+		vi5_sync_collect(chan, buf, &done);
+		goto unlock;
+	}
+	chan->sync_buf = buf;
+
+	list_for_each_entry(it, &grp->channels, sync_entry) {
+		if (!it->sync_buf)
+			goto unlock;
+
+		sof = it->sync_buf->buf.vb2_buf.timestamp;
+		if (sof < sof_min) {
+			sof_min = sof;
+			oldest = it;
+		}
+		sof_max = max(sof_max, sof);
+	}
+
+	if (sof_max - sof_min > (u64)sync_window_us * NSEC_PER_USEC) {
+		vi5_sync_collect(oldest, oldest->sync_buf, &done);
+		oldest->sync_buf = NULL;
+		oldest->sync_unmatched++;
+		goto unlock;
+	}
+
+	drift_us = div_u64(sof_max - sof_min, NSEC_PER_USEC);
+	list_for_each_entry(it, &grp->channels, sync_entry) {
+		vi5_sync_collect(it, it->sync_buf, &done);
+		it->sync_buf = NULL;
+		it->sync_matched++;
+		it->sync_drift_us = drift_us;
+		it->sync_drift_max_us = max(it->sync_drift_max_us, drift_us);
+	}
+
+unlock:
+	atomic_inc(&grp->completing);
+	spin_unlock(&grp->lock);
+
+	vi5_sync_complete(&done);
+	if (atomic_dec_and_test(&grp->completing))
+		wake_up(&grp->wait);
 }
 
 static void vi5_capture_enqueue(struct tegra_channel *chan,
@@ -486,8 +770,21 @@ static void vi5_capture_enqueue(struct tegra_channel *chan,
 	}};
 
 	for (vi_port = 0; vi_port < chan->valid_ports; vi_port++) {
+		u64 setup_ns = 0;
+
+		if (trace_tegra_channel_capture_enqueue_enabled())
+			setup_ns = ktime_get_ns();
+
 		vi5_setup_surface(chan, buf, chan->capture_descr_index, vi_port);
+
+		if (trace_tegra_channel_capture_enqueue_enabled())
+			trace_tegra_channel_capture_enqueue(chan->capture_descr_index,
+				chan->request[vi_port][chan->capture_descr_index].sequence,
+				ktime_get_ns() - setup_ns);
+
 		request[vi_port].buffer_index = chan->capture_descr_index;
+		chan->request_vb2_index[chan->capture_descr_index] =
+			buf->buf.vb2_buf.index;
 
 		err = vi_capture_request(chan->tegra_vi_channel[vi_port], &request[vi_port]);
 
@@ -507,11 +804,7 @@ static void vi5_capture_enqueue(struct tegra_channel *chan,
 	chan->capture_descr_index = ((chan->capture_descr_index + 1)
 					% (chan->capture_queue_depth));
 
-	spin_lock(&chan->dequeue_lock);
-	list_add_tail(&buf->queue, &chan->dequeue);
-	spin_unlock(&chan->dequeue_lock);
-
-	wake_up_interruptible(&chan->dequeue_wait);
+	enqueue_dequeue_buffer(chan, buf);
 
 	return;
 
@@ -521,6 +814,18 @@ uncorr_err:
 	spin_unlock_irqrestore(&chan->capture_state_lock, flags);
 }
 
+/*
+ * RCE descriptor timestamps are nanoseconds of the TSC, which the arch
+ * counter follows. CLOCK_MONOTONIC is offset from it by the boot time.
+ * The counter rate is read from CNTFRQ at stream on, arch_timer_get_rate()
+ * is not exported to modules.
+ */
+static u64 vi5_tsc_now_ns(struct tegra_channel *chan)
+{
+	return mul_u64_u32_div(__arch_counter_get_cntvct(), NSEC_PER_SEC,
+						chan->tsc_rate);
+}
+
 static void vi5_capture_dequeue(struct tegra_channel *chan,
 	struct tegra_channel_buffer *buf)
 {
@@ -540,8 +845,9 @@ static void vi5_capture_dequeue(struct tegra_channel *chan,
 		if (buf->vb2_state != VB2_BUF_STATE_ACTIVE)
 			goto rel_buf;
 
-		/* Dequeue a frame and check its capture status */
-		err = vi_capture_status(chan->tegra_vi_channel[vi_port], CAPTURE_TIMEOUT_MS);
+		/* Wait for this frame's descriptor, frames already done don't sleep */
+		err = vi_capture_status_wait(chan->tegra_vi_channel[vi_port],
+				buf->capture_descr_index[vi_port], CAPTURE_TIMEOUT_MS);
 		if (err) {
 			if (err == -ETIMEDOUT) {
 				dev_err(vi->dev,
@@ -581,7 +887,26 @@ static void vi5_capture_dequeue(struct tegra_channel *chan,
 		spin_unlock_irqrestore(&chan->capture_state_lock, flags);
 	}
 
+	chan->capture_frames++;
+	if (!frame_err)
+		chan->fast_recover_seq = 0;
+	/* VI is left without a request, the next frame will be dropped */
+	if (!chan->capture_reqs_enqueued && list_empty(&chan->capture))
+		chan->capture_starved++;
+
 	wake_up_interruptible(&chan->start_wait);
+
+	buf->dequeue_ns = ktime_get_ns();
+	/* the timestamps of a discarded frame may be unset */
+	if (!frame_err) {
+		tegra_channel_stats_latency(chan, TEGRA_LATENCY_SOF_EOF,
+			descr->status.eof_timestamp -
+			descr->status.sof_timestamp);
+		tegra_channel_stats_latency(chan, TEGRA_LATENCY_EOF_DEQUEUE,
+			vi5_tsc_now_ns(chan) - descr->status.eof_timestamp);
+		tegra_channel_stats_frame(chan, descr->status.frame_id);
+	}
+
 	/* Read SOF from capture descriptor */
 	ts = ns_to_timespec64((s64)descr->status.sof_timestamp);
 	trace_tegra_channel_capture_frame("sof", &ts);
@@ -605,7 +930,57 @@ uncorr_err:
 	buf->vb2_state = VB2_BUF_STATE_ERROR;
 
 rel_buf:
-	vi5_release_buffer(chan, buf);
+	if (buf->vb2_state == VB2_BUF_STATE_ERROR) {
+		spin_lock(&chan->stats_lock);
+		chan->stats.errors++;
+		spin_unlock(&chan->stats_lock);
+	}
+
+	if (chan->sync_grp)
+		vi5_sync_release(chan, buf);
+	else
+		vi5_release_buffer(chan, buf);
+}
+
+/*
+ * Reset the VI channels in place, keeping the RCE channel, the capture
+ * descriptors and the buffer mappings. Requests in flight are discarded
+ * by RCE and their buffers are returned as errors, buffers which have not
+ * been submitted yet stay queued.
+ */
+static int vi5_channel_reset(struct tegra_channel *chan)
+{
+	int err = 0;
+	unsigned int vi_port = 0;
+	unsigned long flags;
+	struct tegra_channel_buffer *buf;
+
+	for (vi_port = 0; vi_port < chan->valid_ports; vi_port++) {
+		err = vi_capture_reset(chan->tegra_vi_channel[vi_port],
+			CAPTURE_CHANNEL_RESET_FLAG_IMMEDIATE);
+		if (err) {
+			dev_dbg(&chan->video->dev,
+				"vi capture reset failed %d\n", err);
+			return err;
+		}
+	}
+
+	while (!kfifo_is_empty(&chan->dequeue)) {
+		buf = dequeue_dequeue_buffer(chan);
+		if (!buf)
+			break;
+		buf->vb2_state = VB2_BUF_STATE_ERROR;
+		vi5_capture_dequeue(chan, buf);
+	}
+
+	spin_lock_irqsave(&chan->capture_state_lock, flags);
+	chan->capture_reqs_enqueued = 0;
+	chan->capture_state = CAPTURE_IDLE;
+	spin_unlock_irqrestore(&chan->capture_state_lock, flags);
+
+	wake_up_interruptible(&chan->start_wait);
+
+	return 0;
 }
 
 static int vi5_channel_error_recover(struct tegra_channel *chan,
@@ -617,6 +992,19 @@ static int vi5_channel_error_recover(struct tegra_channel *chan,
 	struct tegra_mc_vi *vi = chan->vi;
 	struct v4l2_subdev *csi_subdev;
 
+	/*
+	 * The in place reset leaves NVCSI alone, a fault which outlives
+	 * a few of them without a good frame takes the full path below.
+	 */
+	if (!queue_error && chan->fast_recover_seq < CAPTURE_FAST_RECOVER_MAX &&
+		!vi5_channel_reset(chan)) {
+		chan->fast_recover_seq++;
+		chan->fast_recoveries++;
+		return 0;
+	}
+	chan->fast_recover_seq = 0;
+	chan->full_recoveries++;
+
 	/* stop vi channel */
 	for (vi_port = 0; vi_port < chan->valid_ports; vi_port++) {
 		err = vi_capture_release(chan->tegra_vi_channel[vi_port],
@@ -638,7 +1026,7 @@ static int vi5_channel_error_recover(struct tegra_channel *chan,
 			break;
 		vb2_buffer_done(&buf->buf.vb2_buf, VB2_BUF_STATE_ERROR);
 	}
-	while (!list_empty(&chan->dequeue)) {
+	while (!kfifo_is_empty(&chan->dequeue)) {
 		buf = dequeue_dequeue_buffer(chan);
 		if (!buf)
 			break;
@@ -742,10 +1130,10 @@ static int tegra_channel_kthread_capture_dequeue(void *data)
 
 		wait_event_interruptible(chan->dequeue_wait,
 			(kthread_should_stop()
-				|| !list_empty(&chan->dequeue)
+				|| !kfifo_is_empty(&chan->dequeue)
 				|| (chan->capture_state == CAPTURE_ERROR)));
 
-		while (!(kthread_should_stop() || list_empty(&chan->dequeue)
+		while (!(kthread_should_stop() || kfifo_is_empty(&chan->dequeue)
 				|| (chan->capture_state == CAPTURE_ERROR))) {
 
 			buf = dequeue_dequeue_buffer(chan);
@@ -855,6 +1243,8 @@ static int vi5_channel_start_streaming(struct vb2_queue *vq, u32 count)
 	struct camera_common_data *s_data;
 	unsigned int emb_buf_size = 0;
 
+	chan->tsc_rate = arch_timer_get_cntfrq();
+
 	/* Skip in bypass mode */
 	if (!chan->bypass) {
 		for (vi_port = 0; vi_port < chan->valid_ports; vi_port++) {
@@ -937,7 +1327,14 @@ static int vi5_channel_start_streaming(struct vb2_queue *vq, u32 count)
 				goto err_setup;
 		}
 		chan->sequence = 0;
+		chan->stats.frame_id_valid = false;
+		/* embedded data size may have changed, rewrite the headers */
+		if (!++chan->emb_hdr_version)
+			chan->emb_hdr_version++;
 		tegra_channel_init_ring_buffer(chan);
+		ret = vi5_sync_join(chan);
+		if (ret)
+			goto err_start_kthreads;
 
 		ret = vi5_channel_start_kthreads(chan);
 		if (ret != 0)
@@ -963,6 +1360,7 @@ err_set_stream:
 		vi5_channel_stop_kthreads(chan);
 
 err_start_kthreads:
+	vi5_sync_leave(chan);
 	if (!chan->bypass)
 		for (vi_port = 0; vi_port < chan->valid_ports; vi_port++)
 			vi_capture_release(chan->tegra_vi_channel[vi_port],
@@ -991,6 +1389,28 @@ static int vi5_channel_stop_streaming(struct vb2_queue *vq)
 	if (!chan->bypass)
 		vi5_channel_stop_kthreads(chan);
 
+	vi5_sync_leave(chan);
+
+	/*
+	 * The buffers are owned by the application, so a queue which ran dry
+	 * can only be made deeper when it is set up again. A single dry frame
+	 * is a paused application or the drain before STREAMOFF, only a
+	 * stream that kept running dry raises the hint.
+	 */
+	if (chan->capture_starved >= CAPTURE_STARVED_MIN &&
+		chan->capture_starved * CAPTURE_STARVED_RATIO >=
+						chan->capture_frames) {
+		chan->capture_depth_hint = min(chan->capture_queue_depth +
+				CAPTURE_DEPTH_STEP, CAPTURE_MAX_BUFFERS);
+		dev_dbg(&chan->video->dev,
+			"capture starved %u of %u frames, queue depth hint %u\n",
+			chan->capture_starved, chan->capture_frames,
+			chan->capture_depth_hint);
+	}
+	chan->capture_starved = 0;
+	chan->capture_frames = 0;
+	chan->fast_recover_seq = 0;
+
 	/* csi stream/sensor(s) devices to be closed before vi channel */
 	tegra_channel_set_stream(chan, false);
 
@@ -1733,6 +1733,13 @@ static void ether_napi_disable(struct ether_priv_data *pdata)
 		napi_disable(&pdata->tx_napi[chan]->napi);
 		napi_synchronize(&pdata->rx_napi[chan]->napi);
 		napi_disable(&pdata->rx_napi[chan]->napi);
+#ifdef ETHER_DIM
+		/* a cancelled profile update must not stall the next measure */
+		cancel_work_sync(&pdata->tx_napi[chan]->dim.work);
+		pdata->tx_napi[chan]->dim.state = DIM_START_MEASURE;
+		cancel_work_sync(&pdata->rx_napi[chan]->dim.work);
+		pdata->rx_napi[chan]->dim.state = DIM_START_MEASURE;
+#endif
 	}
 }
 
@@ -1754,6 +1761,8 @@ static void ether_napi_enable(struct ether_priv_data *pdata)
 	for (i = 0; i < osi_dma->num_dma_chans; i++) {
 		chan = osi_dma->dma_chans[i];
 
+		/* DIM starts again from the configured tx-usecs */
+		pdata->tx_napi[chan]->tx_usecs = osi_dma->tx_usecs;
 		napi_enable(&pdata->tx_napi[chan]->napi);
 		napi_enable(&pdata->rx_napi[chan]->napi);
 	}
@@ -1837,6 +1846,10 @@ static void free_rx_dma_resources(struct osi_dma_priv_data *osi_dma,
 			osi_dma->rx_ring[i] = NULL;
 		}
 #ifdef ETHER_PAGE_POOL
+		if (chan != ETHER_INVALID_CHAN_NUM &&
+		    xdp_rxq_info_is_reg(&pdata->xdp_rxq[chan]))
+			xdp_rxq_info_unreg(&pdata->xdp_rxq[chan]);
+
 		if (chan != ETHER_INVALID_CHAN_NUM && pdata->page_pool[chan]) {
 			page_pool_destroy(pdata->page_pool[chan]);
 			pdata->page_pool[chan] = NULL;
@@ -1947,7 +1960,8 @@ static int ether_allocate_rx_buffers(struct ether_priv_data *pdata,
 				return -ENOMEM;
 			}
 
-			dma_addr = page_pool_get_dma_addr(page);
+			dma_addr = page_pool_get_dma_addr(page) +
+				   pdata->rx_headroom;
 			rx_swcx->buf_virt_addr = page;
 		}
 #else
@@ -1992,15 +2006,27 @@ static int ether_page_pool_create_per_chan(struct ether_priv_data *pdata,
 	struct osi_dma_priv_data *osi_dma = pdata->osi_dma;
 	struct page_pool_params pp_params = { 0 };
 	unsigned int num_pages, pool_size = 1024;
+	unsigned int tailroom = 0;
 	int ret = 0;
 
-	pp_params.flags = PP_FLAG_DMA_MAP;
+	/*
+	 * XDP reports the whole page as frame size, tail growth and skbs built
+	 * from redirected frames place skb_shared_info at its end.
+	 */
+	if (pdata->xdp_prog)
+		tailroom = SKB_DATA_ALIGN(sizeof(struct skb_shared_info));
+
+	/* pages come back from the stack, so sync them before reuse */
+	pp_params.flags = PP_FLAG_DMA_MAP | PP_FLAG_DMA_SYNC_DEV;
 	pp_params.pool_size = pool_size;
-	num_pages = DIV_ROUND_UP(osi_dma->rx_buf_len, PAGE_SIZE);
+	num_pages = DIV_ROUND_UP(pdata->rx_headroom + osi_dma->rx_buf_len +
+				 tailroom, PAGE_SIZE);
 	pp_params.order = ilog2(roundup_pow_of_two(num_pages));
 	pp_params.nid = dev_to_node(pdata->dev);
 	pp_params.dev = pdata->dev;
 	pp_params.dma_dir = DMA_FROM_DEVICE;
+	pp_params.offset = pdata->rx_headroom;
+	pp_params.max_len = osi_dma->rx_buf_len;
 
 	pdata->page_pool[chan] = page_pool_create(&pp_params);
 	if (IS_ERR(pdata->page_pool[chan])) {
@@ -2009,6 +2035,18 @@ static int ether_page_pool_create_per_chan(struct ether_priv_data *pdata,
 		return ret;
 	}
 
+	ret = xdp_rxq_info_reg(&pdata->xdp_rxq[chan], pdata->ndev, chan, 0);
+	if (ret < 0)
+		return ret;
+
+	ret = xdp_rxq_info_reg_mem_model(&pdata->xdp_rxq[chan],
+					 MEM_TYPE_PAGE_POOL,
+					 pdata->page_pool[chan]);
+	if (ret < 0) {
+		xdp_rxq_info_unreg(&pdata->xdp_rxq[chan]);
+		return ret;
+	}
+
 	return ret;
 }
 #endif
@@ -2034,6 +2072,11 @@ static int ether_allocate_rx_dma_resources(struct osi_dma_priv_data *osi_dma,
 	unsigned int i;
 	int ret = 0;
 
+#ifdef ETHER_PAGE_POOL
+	/* XDP programs may push headers in front of the packet */
+	pdata->rx_headroom = pdata->xdp_prog ? XDP_PACKET_HEADROOM : 0U;
+#endif
+
 	for (i = 0; i < OSI_MGBE_MAX_NUM_CHANS; i++) {
 		chan = osi_dma->dma_chans[i];
 
@@ -2950,7 +2993,6 @@ static int ether_close(struct net_device *ndev)
 
 #ifdef ETHER_NVGRO
 	del_timer_sync(&pdata->nvgro_timer);
-	/* TODO: purge the queues */
 #endif
 
 #ifdef CONFIG_TEGRA_NVPPS
@@ -3010,6 +3052,14 @@ static int ether_close(struct net_device *ndev)
 
 	ether_napi_disable(pdata);
 
+#ifdef ETHER_NVGRO
+	/* Rx NAPIs are stopped, drop the packets still held by NVGRO */
+	for (i = 0; i < pdata->osi_dma->num_dma_chans; i++) {
+		chan = pdata->osi_dma->dma_chans[i];
+		ether_nvgro_purge(pdata->rx_napi[chan], true);
+	}
+#endif
+
 	/* free DMA resources after DMA stop */
 	free_dma_resources(pdata);
 
@@ -3446,8 +3496,8 @@ static int ether_start_xmit(struct sk_buff *skb, struct net_device *ndev)
 		atomic_set(&pdata->tx_napi[chan]->tx_usecs_timer_armed,
 			   OSI_ENABLE);
 		hrtimer_start(&pdata->tx_napi[chan]->tx_usecs_timer,
-			      osi_dma->tx_usecs * NSEC_PER_USEC,
-			      HRTIMER_MODE_REL);
+			      READ_ONCE(pdata->tx_napi[chan]->tx_usecs) *
+			      NSEC_PER_USEC, HRTIMER_MODE_REL);
 	}
 	return NETDEV_TX_OK;
 }
@@ -4267,6 +4317,44 @@ static int ether_setup_tc(struct net_device *ndev, enum tc_setup_type type,
 	}
 }
 
+#ifdef ETHER_PAGE_POOL
+/**
+ * @brief Attach or detach the XDP program.
+ *
+ * Algorithm: Rx buffers are laid out for XDP when the rings are allocated,
+ * so the program can only be changed while the interface is down, as for
+ * an MTU change.
+ *
+ * @param[in] ndev: Network device structure
+ * @param[in] bpf: XDP command.
+ *
+ * @retval 0 on success
+ * @retval "negative value" on failure.
+ */
+static int ether_bpf(struct net_device *ndev, struct netdev_bpf *bpf)
+{
+	struct ether_priv_data *pdata = netdev_priv(ndev);
+	struct bpf_prog *old_prog;
+
+	switch (bpf->command) {
+	case XDP_SETUP_PROG:
+		if (netif_running(ndev)) {
+			NL_SET_ERR_MSG_MOD(bpf->extack,
+					   "must be stopped to change XDP program");
+			return -EBUSY;
+		}
+
+		old_prog = xchg(&pdata->xdp_prog, bpf->prog);
+		if (old_prog)
+			bpf_prog_put(old_prog);
+
+		return 0;
+	default:
+		return -EINVAL;
+	}
+}
+#endif
+
 /**
  * @brief Ethernet network device operations
  */
@@ -4289,8 +4377,99 @@ static const struct net_device_ops ether_netdev_ops = {
 	.ndo_vlan_rx_kill_vid = ether_vlan_rx_kill_vid,
 #endif /* ETHER_VLAN_VID_SUPPORT */
 	.ndo_setup_tc = ether_setup_tc,
+#ifdef ETHER_PAGE_POOL
+	.ndo_bpf = ether_bpf,
+#endif
 };
 
+#ifdef ETHER_DIM
+/**
+ * @brief Apply the Rx moderation profile selected by DIM.
+ *
+ * Algorithm: Reprograms the Rx interrupt watchdog timer of the channel
+ * with the usec value of the profile, clamped to the range supported
+ * by the MAC.
+ *
+ * @param[in] work: DIM work of the Rx channel.
+ */
+static void ether_rx_dim_work(struct work_struct *work)
+{
+	struct dim *dim = container_of(work, struct dim, work);
+	struct ether_rx_napi *rx_napi =
+		container_of(dim, struct ether_rx_napi, dim);
+	struct osi_dma_priv_data *osi_dma = rx_napi->pdata->osi_dma;
+	struct dim_cq_moder moder;
+	unsigned int min_usecs;
+	unsigned int usecs;
+
+	moder = net_dim_get_rx_moderation(dim->mode, dim->profile_ix);
+	min_usecs = (osi_dma->mac == OSI_MAC_HW_MGBE) ?
+		    ETHER_MGBE_MIN_RX_COALESCE_USEC :
+		    ETHER_EQOS_MIN_RX_COALESCE_USEC;
+	usecs = clamp_t(unsigned int, moder.usec, min_usecs,
+			ETHER_MAX_RX_COALESCE_USEC);
+
+	if (osi_config_rx_riwt(osi_dma, rx_napi->chan, usecs) < 0)
+		netdev_dbg(rx_napi->pdata->ndev,
+			   "failed to set Rx[%u] RIWT\n", rx_napi->chan);
+
+	dim->state = DIM_START_MEASURE;
+}
+
+/**
+ * @brief Apply the Tx moderation profile selected by DIM.
+ *
+ * Algorithm: Updates the SW timer period and, when tx-frames is in use,
+ * the number of frames per Tx completion interrupt of the channel.
+ *
+ * @param[in] work: DIM work of the Tx channel.
+ */
+static void ether_tx_dim_work(struct work_struct *work)
+{
+	struct dim *dim = container_of(work, struct dim, work);
+	struct ether_tx_napi *tx_napi =
+		container_of(dim, struct ether_tx_napi, dim);
+	struct osi_dma_priv_data *osi_dma = tx_napi->pdata->osi_dma;
+	struct osi_tx_ring *tx_ring = osi_dma->tx_ring[tx_napi->chan];
+	struct dim_cq_moder moder;
+
+	moder = net_dim_get_tx_moderation(dim->mode, dim->profile_ix);
+	WRITE_ONCE(tx_napi->tx_usecs,
+		   clamp_t(unsigned int, moder.usec,
+			   ETHER_MIN_TX_COALESCE_USEC,
+			   ETHER_MAX_TX_COALESCE_USEC));
+
+	if (osi_dma->use_tx_frames == OSI_ENABLE)
+		WRITE_ONCE(tx_ring->tx_frames,
+			   clamp_t(unsigned int, moder.pkts,
+				   ETHER_MIN_TX_COALESCE_FRAMES,
+				   ETHER_TX_MAX_FRAME(osi_dma->tx_ring_sz)));
+
+	dim->state = DIM_START_MEASURE;
+}
+
+/**
+ * @brief Feed a DIM sample at the end of a NAPI poll.
+ *
+ * @param[in] dim: DIM instance of the channel.
+ * @param[in] events: Interrupt counter of the channel.
+ * @param[in] pkts: Packets processed by the channel.
+ * @param[in] bytes: Bytes processed by the channel.
+ */
+static void ether_dim_update(struct dim *dim, u16 events, u64 pkts,
+			     u64 bytes)
+{
+	struct dim_sample sample = {};
+
+	dim_update_sample(events, pkts, bytes, &sample);
+#if defined(NV_NET_DIM_HAS_SAMPLE_PTR_ARG) /* Linux v6.13 */
+	net_dim(dim, &sample);
+#else
+	net_dim(dim, sample);
+#endif
+}
+#endif /* ETHER_DIM */
+
 /**
  * @brief NAPI poll handler for receive.
  *
@@ -4317,8 +4496,29 @@ static int ether_napi_poll_rx(struct napi_struct *napi, int budget)
 
 	received = osi_process_rx_completions(osi_dma, chan, budget,
 					      &more_data_avail);
+#ifdef ETHER_PAGE_POOL
+	if (rx_napi->xdp_flush) {
+		rx_napi->xdp_flush = false;
+		xdp_do_flush();
+	}
+#endif
+#ifdef ETHER_NVGRO
+	if (READ_ONCE(rx_napi->nvgro_purge)) {
+		WRITE_ONCE(rx_napi->nvgro_purge, false);
+		ether_nvgro_purge(rx_napi, false);
+	}
+#endif
+#ifdef ETHER_DIM
+	rx_napi->dim_pkts += received;
+#endif
 	if (received < budget) {
 		napi_complete(napi);
+#ifdef ETHER_DIM
+		if (pdata->use_rx_dim == OSI_ENABLE)
+			ether_dim_update(&rx_napi->dim, rx_napi->dim_events++,
+					 rx_napi->dim_pkts,
+					 rx_napi->dim_bytes);
+#endif
 		raw_spin_lock_irqsave(&pdata->rlock, flags);
 		osi_handle_dma_intr(osi_dma, chan,
 				    OSI_DMA_CH_RX_INTR,
@@ -4360,12 +4560,18 @@ static int ether_napi_poll_tx(struct napi_struct *napi, int budget)
 	    atomic_read(&tx_napi->tx_usecs_timer_armed) == OSI_DISABLE) {
 		atomic_set(&tx_napi->tx_usecs_timer_armed, OSI_ENABLE);
 		hrtimer_start(&tx_napi->tx_usecs_timer,
-			      osi_dma->tx_usecs * NSEC_PER_USEC,
+			      READ_ONCE(tx_napi->tx_usecs) * NSEC_PER_USEC,
 			      HRTIMER_MODE_REL);
 	}
 
 	if (processed < budget) {
 		napi_complete(napi);
+#ifdef ETHER_DIM
+		if (pdata->use_tx_dim == OSI_ENABLE)
+			ether_dim_update(&tx_napi->dim, tx_napi->dim_events++,
+					 tx_napi->dim_pkts,
+					 tx_napi->dim_bytes);
+#endif
 		raw_spin_lock_irqsave(&pdata->rlock, flags);
 		osi_handle_dma_intr(osi_dma, chan,
 				    OSI_DMA_CH_TX_INTR,
@@ -4415,6 +4621,9 @@ static int ether_alloc_napi(struct ether_priv_data *pdata)
 	struct device *dev = pdata->dev;
 	unsigned int chan;
 	unsigned int i;
+#ifdef ETHER_NVGRO
+	unsigned int j;
+#endif
 
 	for (i = 0; i < osi_dma->num_dma_chans; i++) {
 		chan = osi_dma->dma_chans[i];
@@ -4429,6 +4638,10 @@ static int ether_alloc_napi(struct ether_priv_data *pdata)
 
 		pdata->tx_napi[chan]->pdata = pdata;
 		pdata->tx_napi[chan]->chan = chan;
+#ifdef ETHER_DIM
+		INIT_WORK(&pdata->tx_napi[chan]->dim.work, ether_tx_dim_work);
+		pdata->tx_napi[chan]->dim.mode = DIM_CQ_PERIOD_MODE_START_FROM_EQE;
+#endif
 #if defined(NV_NETIF_NAPI_ADD_WEIGHT_PRESENT) /* Linux v6.1 */
 		netif_napi_add_weight(ndev, &pdata->tx_napi[chan]->napi,
 			       ether_napi_poll_tx, 64);
@@ -4447,6 +4660,16 @@ static int ether_alloc_napi(struct ether_priv_data *pdata)
 
 		pdata->rx_napi[chan]->pdata = pdata;
 		pdata->rx_napi[chan]->chan = chan;
+#ifdef ETHER_DIM
+		INIT_WORK(&pdata->rx_napi[chan]->dim.work, ether_rx_dim_work);
+		pdata->rx_napi[chan]->dim.mode = DIM_CQ_PERIOD_MODE_START_FROM_EQE;
+#endif
+#ifdef ETHER_NVGRO
+		for (j = 0; j < NVGRO_FLOW_BUCKETS; j++) {
+			__skb_queue_head_init(&pdata->rx_napi[chan]->nvgro_flows[j].mq);
+			__skb_queue_head_init(&pdata->rx_napi[chan]->nvgro_flows[j].fq);
+		}
+#endif
 #if defined(NV_NETIF_NAPI_ADD_WEIGHT_PRESENT) /* Linux v6.1 */
 		netif_napi_add_weight(ndev, &pdata->rx_napi[chan]->napi,
 			       ether_napi_poll_rx, 64);
@@ -6721,11 +6944,8 @@ static int ether_probe(struct platform_device *pdev)
 	tasklet_setup(&pdata->lane_restart_task,
 		      ether_restart_lane_bringup_task);
 #ifdef ETHER_NVGRO
-	__skb_queue_head_init(&pdata->mq);
-	__skb_queue_head_init(&pdata->fq);
 	pdata->pkt_age_msec = NVGRO_AGE_THRESHOLD;
 	pdata->nvgro_timer_intrvl = NVGRO_PURGE_TIMER_THRESHOLD;
-	pdata->nvgro_dropped = 0;
 	timer_setup(&pdata->nvgro_timer, ether_nvgro_purge_timer, 0);
 #endif
 
@@ -45,8 +45,16 @@
 #include <net/page_pool/types.h>
 #include <net/page_pool/helpers.h>
 #endif
+#include <linux/bpf.h>
+#include <linux/bpf_trace.h>
+#include <linux/filter.h>
+#include <net/xdp.h>
 #define ETHER_PAGE_POOL
 #endif
+#if IS_ENABLED(CONFIG_DIMLIB)
+#include <linux/dim.h>
+#define ETHER_DIM
+#endif
 #include <osi_core.h>
 #include <osi_dma.h>
 #include <mmc.h>
@@ -56,6 +64,7 @@
 #include "macsec.h"
 #endif
 #ifdef ETHER_NVGRO
+#include <linux/jhash.h>
 #include <net/inet_common.h>
 #include <uapi/linux/ip.h>
 #include <net/udp.h>
@@ -198,6 +207,12 @@
  */
 #define ETHER_TX_MAX_FRAME_SIZE	GSO_MAX_SIZE
 
+/**
+ * @brief Rx packets up to this length are copied out of the page pool
+ * buffer, larger ones keep their payload in the page as an skb frag.
+ */
+#define ETHER_RX_COPYBREAK	256U
+
 /**
  * @brief IVC wait timeout cnt in micro seconds.
  */
@@ -215,8 +230,8 @@
 /* NVGRO packets purge threshold in msec */
 #define NVGRO_AGE_THRESHOLD		500
 #define NVGRO_PURGE_TIMER_THRESHOLD	5000
-#define NVGRO_RX_RUNNING		OSI_BIT(0)
-#define NVGRO_PURGE_TIMER_RUNNING	OSI_BIT(1)
+/* NVGRO flows tracked per Rx channel, power of two */
+#define NVGRO_FLOW_BUCKETS		8U
 #endif
 
 /**
@@ -329,8 +344,42 @@ struct ether_tx_napi {
 	struct hrtimer tx_usecs_timer;
 	/** SW timer flag associated with transmit channel */
 	atomic_t tx_usecs_timer_armed;
+	/** SW timer period in usec, retuned by DIM when enabled */
+	unsigned int tx_usecs;
+#ifdef ETHER_DIM
+	/** Dynamic interrupt moderation state */
+	struct dim dim;
+	/** Tx interrupts seen by DIM */
+	u16 dim_events;
+	/** Packets completed, sampled by DIM */
+	u64 dim_pkts;
+	/** Bytes completed, sampled by DIM */
+	u64 dim_bytes;
+#endif
 };
 
+#ifdef ETHER_NVGRO
+/**
+ * @brief NVGRO reassembly state of one UDP flow
+ */
+struct ether_nvgro_flow {
+	/** IPv4 source address */
+	__be32 saddr;
+	/** IPv4 destination address */
+	__be32 daddr;
+	/** UDP source port */
+	__be16 source;
+	/** UDP destination port */
+	__be16 dest;
+	/** expected IP ID */
+	u16 expected_ip_id;
+	/** Master queue, out of order segments */
+	struct sk_buff_head mq;
+	/** Final queue, in order segments from the first one */
+	struct sk_buff_head fq;
+};
+#endif
+
 /**
  *@brief DMA Receive Channel NAPI
  */
@@ -341,6 +390,28 @@ struct ether_rx_napi {
 	struct ether_priv_data *pdata;
 	/** NAPI instance associated with transmit channel */
 	struct napi_struct napi;
+	/** XDP redirects are pending a flush at the end of the poll */
+	bool xdp_flush;
+#ifdef ETHER_NVGRO
+	/** NVGRO flows hashed by UDP 4-tuple, only used in NAPI context */
+	struct ether_nvgro_flow nvgro_flows[NVGRO_FLOW_BUCKETS];
+	/** Segments are queued in nvgro_flows */
+	bool nvgro_pending;
+	/** Purge timer asks the NAPI poll to purge aged segments */
+	bool nvgro_purge;
+	/** NVGRO packet dropped count */
+	u64 nvgro_dropped;
+#endif
+#ifdef ETHER_DIM
+	/** Dynamic interrupt moderation state */
+	struct dim dim;
+	/** Rx interrupts seen by DIM */
+	u16 dim_events;
+	/** Packets received, sampled by DIM */
+	u64 dim_pkts;
+	/** Bytes received, sampled by DIM */
+	u64 dim_bytes;
+#endif
 };
 
 /**
@@ -417,6 +488,10 @@ struct ether_xtra_stat_counters {
 	nveu64_t tx_usecs_swtimer_n[OSI_MGBE_MAX_NUM_QUEUES];
 	/** RX per channel interrupt count */
 	nveu64_t rx_normal_irq_n[OSI_MGBE_MAX_NUM_QUEUES];
+	/** RX per channel packets dropped by XDP */
+	nveu64_t xdp_drop_n[OSI_MGBE_MAX_NUM_QUEUES];
+	/** RX per channel packets redirected by XDP */
+	nveu64_t xdp_redirect_n[OSI_MGBE_MAX_NUM_QUEUES];
 	/** link connect count */
 	nveu64_t link_connect_count;
 	/** link disconnect count */
@@ -577,7 +652,17 @@ struct ether_priv_data {
 #ifdef ETHER_PAGE_POOL
 	/** Pointer to page pool */
 	struct page_pool *page_pool[OSI_MGBE_MAX_NUM_CHANS];
+	/** XDP program run on received packets */
+	struct bpf_prog *xdp_prog;
+	/** Rx buffer headroom, reserved while an XDP program is attached */
+	unsigned int rx_headroom;
+	/** XDP Rx queue info per channel */
+	struct xdp_rxq_info xdp_rxq[OSI_MGBE_MAX_NUM_CHANS];
 #endif
+	/** Adaptive Rx coalescing enabled(1) or disabled(0) */
+	unsigned int use_rx_dim;
+	/** Adaptive Tx coalescing enabled(1) or disabled(0) */
+	unsigned int use_tx_dim;
 #ifdef CONFIG_DEBUG_FS
 	/** Debug fs directory pointer */
 	struct dentry *dbgfs_dir;
@@ -617,24 +702,12 @@ struct ether_priv_data {
 	/** PHY reset duration delay */
 	int phy_reset_duration;
 #ifdef ETHER_NVGRO
-	/** Master queue */
-	struct sk_buff_head mq;
-	/** Master queue */
-	struct sk_buff_head fq;
-	/** expected IP ID */
-	u16 expected_ip_id;
-	/** Timer for purginging the packets in FQ and MQ based on threshold */
+	/** Timer kicking the Rx NAPIs to purge NVGRO packets on threshold */
 	struct timer_list nvgro_timer;
-	/** Rx processing state for NVGRO */
-	atomic_t rx_state;
-	/** Purge timer state for NVGRO */
-	atomic_t timer_state;
 	/** NVGRO packet age threshold in milseconds */
 	u32 pkt_age_msec;
 	/** NVGRO purge timer interval */
 	u32 nvgro_timer_intrvl;
-	/** NVGRO packet dropped count */
-	u64 nvgro_dropped;
 #endif
 	/** Platform MDIO address */
 	unsigned int mdio_addr;
@@ -857,5 +930,6 @@ int ether_get_tx_ts(struct ether_priv_data *pdata);
 void ether_restart_lane_bringup_task(struct tasklet_struct *t);
 #ifdef ETHER_NVGRO
 void ether_nvgro_purge_timer(struct timer_list *t);
+void ether_nvgro_purge(struct ether_rx_napi *rx_napi, bool all);
 #endif /* ETHER_NVGRO */
 #endif /* ETHER_LINUX_H */
@@ -196,6 +196,26 @@ static const struct ether_stats ether_gstrings_stats[] = {
 	ETHER_EXTRA_STAT(rx_normal_irq_n[7]),
 	ETHER_EXTRA_STAT(rx_normal_irq_n[8]),
 	ETHER_EXTRA_STAT(rx_normal_irq_n[9]),
+	ETHER_EXTRA_STAT(xdp_drop_n[0]),
+	ETHER_EXTRA_STAT(xdp_drop_n[1]),
+	ETHER_EXTRA_STAT(xdp_drop_n[2]),
+	ETHER_EXTRA_STAT(xdp_drop_n[3]),
+	ETHER_EXTRA_STAT(xdp_drop_n[4]),
+	ETHER_EXTRA_STAT(xdp_drop_n[5]),
+	ETHER_EXTRA_STAT(xdp_drop_n[6]),
+	ETHER_EXTRA_STAT(xdp_drop_n[7]),
+	ETHER_EXTRA_STAT(xdp_drop_n[8]),
+	ETHER_EXTRA_STAT(xdp_drop_n[9]),
+	ETHER_EXTRA_STAT(xdp_redirect_n[0]),
+	ETHER_EXTRA_STAT(xdp_redirect_n[1]),
+	ETHER_EXTRA_STAT(xdp_redirect_n[2]),
+	ETHER_EXTRA_STAT(xdp_redirect_n[3]),
+	ETHER_EXTRA_STAT(xdp_redirect_n[4]),
+	ETHER_EXTRA_STAT(xdp_redirect_n[5]),
+	ETHER_EXTRA_STAT(xdp_redirect_n[6]),
+	ETHER_EXTRA_STAT(xdp_redirect_n[7]),
+	ETHER_EXTRA_STAT(xdp_redirect_n[8]),
+	ETHER_EXTRA_STAT(xdp_redirect_n[9]),
 	ETHER_EXTRA_STAT(link_disconnect_count),
 	ETHER_EXTRA_STAT(link_connect_count),
 };
@@ -900,7 +920,9 @@ static int ether_get_ts_info(struct net_device *ndev,
  * Algorithm: This function is invoked by kernel when user request to set
  * interrupt coalescing parameters. This driver maintains same coalescing
  * parameters for all the channels, hence same changes will be applied to
- * all the channels.
+ * all the channels. With adaptive Rx/Tx coalescing, DIM retunes rx-usecs,
+ * tx-usecs and tx-frames per channel at run time, starting from these
+ * values.
  *
  * @param[in] dev: Net device data.
  * @param[in] ec: pointer to ethtool_coalesce structure
@@ -932,7 +954,9 @@ static int ether_set_coalesce(struct net_device *dev,
 	/* Check for not supported parameters  */
 	if ((ec->rx_coalesce_usecs_irq) ||
 	    (ec->rx_max_coalesced_frames_irq) || (ec->tx_coalesce_usecs_irq) ||
+#ifndef ETHER_DIM
 	    (ec->use_adaptive_rx_coalesce) || (ec->use_adaptive_tx_coalesce) ||
+#endif
 	    (ec->pkt_rate_low) || (ec->rx_coalesce_usecs_low) ||
 	    (ec->rx_max_coalesced_frames_low) || (ec->tx_coalesce_usecs_high) ||
 	    (ec->tx_max_coalesced_frames_low) || (ec->pkt_rate_high) ||
@@ -1027,6 +1051,18 @@ static int ether_set_coalesce(struct net_device *dev,
 			   " along with rx-usecs\n");
 		return -EINVAL;
 	}
+	/* DIM retunes the HW/SW timers, so they have to be in use */
+	if (ec->use_adaptive_rx_coalesce && osi_dma->use_riwt == OSI_DISABLE) {
+		netdev_err(dev, "invalid settings : adaptive-rx must be enabled"
+			   " along with rx-usecs\n");
+		return -EINVAL;
+	}
+	if (ec->use_adaptive_tx_coalesce &&
+	    osi_dma->use_tx_usecs == OSI_DISABLE) {
+		netdev_err(dev, "invalid settings : adaptive-tx must be enabled"
+			   " along with tx-usecs\n");
+		return -EINVAL;
+	}
 	netdev_err(dev, "RX COALESCING USECS is %s\n", osi_dma->use_riwt ?
 		   "ENABLED" : "DISABLED");
 
@@ -1037,6 +1073,10 @@ static int ether_set_coalesce(struct net_device *dev,
 	osi_dma->rx_frames = ec->rx_max_coalesced_frames;
 	osi_dma->tx_usecs = ec->tx_coalesce_usecs;
 	osi_dma->tx_frames = ec->tx_max_coalesced_frames;
+	pdata->use_rx_dim = ec->use_adaptive_rx_coalesce ? OSI_ENABLE :
+			    OSI_DISABLE;
+	pdata->use_tx_dim = ec->use_adaptive_tx_coalesce ? OSI_ENABLE :
+			    OSI_DISABLE;
 	return 0;
 }
 
@@ -1073,6 +1113,8 @@ static int ether_get_coalesce(struct net_device *dev,
 	ec->rx_max_coalesced_frames = osi_dma->rx_frames;
 	ec->tx_coalesce_usecs = osi_dma->tx_usecs;
 	ec->tx_max_coalesced_frames = osi_dma->tx_frames;
+	ec->use_adaptive_rx_coalesce = pdata->use_rx_dim;
+	ec->use_adaptive_tx_coalesce = pdata->use_tx_dim;
 
 	return 0;
 }
@@ -1628,8 +1670,13 @@ static const struct ethtool_ops ether_ethtool_ops = {
 	.get_ethtool_stats = ether_get_ethtool_stats,
 	.get_sset_count = ether_get_sset_count,
 	.get_coalesce = ether_get_coalesce,
+#ifdef ETHER_DIM
+	.supported_coalesce_params = (ETHTOOL_COALESCE_USECS |
+		ETHTOOL_COALESCE_MAX_FRAMES | ETHTOOL_COALESCE_USE_ADAPTIVE),
+#else
 	.supported_coalesce_params = (ETHTOOL_COALESCE_USECS |
 		ETHTOOL_COALESCE_MAX_FRAMES),
+#endif
 	.set_coalesce = ether_set_coalesce,
 #ifndef OSI_STRIPPED_LIB
 	.get_wol = ether_get_wol,
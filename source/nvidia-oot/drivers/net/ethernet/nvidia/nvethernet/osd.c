@@ -253,7 +253,8 @@ static inline int ether_alloc_skb(struct ether_priv_data *pdata,
 		return 0;
 	}
 
-	rx_swcx->buf_phy_addr = page_pool_get_dma_addr(rx_swcx->buf_virt_addr);
+	rx_swcx->buf_phy_addr = page_pool_get_dma_addr(rx_swcx->buf_virt_addr) +
+				pdata->rx_headroom;
 #endif
 #ifndef ETHER_PAGE_POOL
 	rx_swcx->buf_virt_addr = skb;
@@ -379,21 +380,23 @@ static inline void ether_gro_merge_complete(struct sk_buff_head *nvgro_q,
 /**
  * @brief ether_update_fq_with_fs - Populates final queue with TTL = 1 packet
  *
- * @param[in] pdata: Ethernet driver private data
+ * @param[in] rx_napi: Rx NAPI the flow belongs to.
+ * @param[in] flow: NVGRO flow.
  * @param[in] skb: Socket buffer.
  */
-static inline void ether_update_fq_with_fs(struct ether_priv_data *pdata,
+static inline void ether_update_fq_with_fs(struct ether_rx_napi *rx_napi,
+					   struct ether_nvgro_flow *flow,
 					   struct sk_buff *skb)
 {
-	if (!skb_queue_empty(&pdata->fq)) {
-		pdata->nvgro_dropped += pdata->fq.qlen;
-		__skb_queue_purge(&pdata->fq);
+	if (!skb_queue_empty(&flow->fq)) {
+		rx_napi->nvgro_dropped += flow->fq.qlen;
+		__skb_queue_purge(&flow->fq);
 	}
 
 	/* queue skb to fq which has TTL = 1 */
-	__skb_queue_tail(&pdata->fq, skb);
+	__skb_queue_tail(&flow->fq, skb);
 
-	pdata->expected_ip_id = NAPI_GRO_CB(skb)->flush_id + 1;
+	flow->expected_ip_id = NAPI_GRO_CB(skb)->flush_id + 1;
 }
 
 /**
@@ -458,18 +461,21 @@ static inline void ether_gro(struct sk_buff_head *fq, struct sk_buff_head *mq,
 /**
  * @brief ether_purge_q - Purge master queue based on packet age.
  *
- * @param[in] pdata: Ethernet private data.
+ * @param[in] rx_napi: Rx NAPI the flow belongs to.
+ * @param[in] flow: NVGRO flow.
  */
-static inline void ether_purge_q(struct ether_priv_data *pdata)
+static inline void ether_purge_q(struct ether_rx_napi *rx_napi,
+				 struct ether_nvgro_flow *flow)
 {
+	struct ether_priv_data *pdata = rx_napi->pdata;
 	struct sk_buff *p, *pp;
 
-	skb_queue_walk_safe(&pdata->mq, p, pp) {
+	skb_queue_walk_safe(&flow->mq, p, pp) {
 		if ((jiffies - NAPI_GRO_CB(p)->age) >
 		    msecs_to_jiffies(pdata->pkt_age_msec)) {
-			__skb_unlink(p, &pdata->mq);
+			__skb_unlink(p, &flow->mq);
 			dev_consume_skb_any(p);
-			pdata->nvgro_dropped++;
+			rx_napi->nvgro_dropped++;
 		} else {
 			return;
 		}
@@ -477,34 +483,72 @@ static inline void ether_purge_q(struct ether_priv_data *pdata)
 }
 
 /**
- * @brief ether_nvgro_purge_timer - NVGRO purge timer handler.
+ * @brief ether_nvgro_purge - Purge NVGRO packets of an Rx channel.
  *
- * @param[in] t: Pointer to the timer.
+ * Algorithm: Drops the packets older than the age threshold, or all of
+ * them. Runs in the Rx NAPI context of the channel, or with it disabled.
+ *
+ * @param[in] rx_napi: Rx NAPI instance.
+ * @param[in] all: Drop all queued packets.
  */
-void ether_nvgro_purge_timer(struct timer_list *t)
+void ether_nvgro_purge(struct ether_rx_napi *rx_napi, bool all)
 {
-	struct ether_priv_data *pdata = from_timer(pdata, t, nvgro_timer);
+	struct ether_priv_data *pdata = rx_napi->pdata;
+	struct ether_nvgro_flow *flow;
 	struct sk_buff *f_skb;
+	bool pending = false;
+	unsigned int i;
 
-	if (atomic_read(&pdata->rx_state) == OSI_ENABLE)
-		return;
+	for (i = 0; i < NVGRO_FLOW_BUCKETS; i++) {
+		flow = &rx_napi->nvgro_flows[i];
 
-	atomic_set(&pdata->timer_state, OSI_ENABLE);
+		if (all) {
+			rx_napi->nvgro_dropped += flow->mq.qlen + flow->fq.qlen;
+			__skb_queue_purge(&flow->mq);
+			__skb_queue_purge(&flow->fq);
+			continue;
+		}
 
-	ether_purge_q(pdata);
+		ether_purge_q(rx_napi, flow);
 
-	f_skb = skb_peek(&pdata->fq);
-	if (!f_skb)
-		goto exit;
+		f_skb = skb_peek(&flow->fq);
+		if (f_skb && (jiffies - NAPI_GRO_CB(f_skb)->age) >
+		    msecs_to_jiffies(pdata->pkt_age_msec)) {
+			rx_napi->nvgro_dropped += flow->fq.qlen;
+			__skb_queue_purge(&flow->fq);
+		}
 
-	if ((jiffies - NAPI_GRO_CB(f_skb)->age) >
-	    msecs_to_jiffies(pdata->pkt_age_msec)) {
-		pdata->nvgro_dropped += pdata->fq.qlen;
-		__skb_queue_purge(&pdata->fq);
+		if (!skb_queue_empty(&flow->mq) || !skb_queue_empty(&flow->fq))
+			pending = true;
 	}
 
-exit:
-	atomic_set(&pdata->timer_state, OSI_DISABLE);
+	WRITE_ONCE(rx_napi->nvgro_pending, pending);
+}
+
+/**
+ * @brief ether_nvgro_purge_timer - NVGRO purge timer handler.
+ *
+ * Algorithm: The NVGRO queues belong to the Rx NAPI of each channel, so
+ * the timer only schedules the NAPIs which hold packets to purge them.
+ *
+ * @param[in] t: Pointer to the timer.
+ */
+void ether_nvgro_purge_timer(struct timer_list *t)
+{
+	struct ether_priv_data *pdata = from_timer(pdata, t, nvgro_timer);
+	struct osi_dma_priv_data *osi_dma = pdata->osi_dma;
+	struct ether_rx_napi *rx_napi;
+	unsigned int i;
+
+	for (i = 0; i < osi_dma->num_dma_chans; i++) {
+		rx_napi = pdata->rx_napi[osi_dma->dma_chans[i]];
+
+		if (!READ_ONCE(rx_napi->nvgro_pending))
+			continue;
+
+		WRITE_ONCE(rx_napi->nvgro_purge, true);
+		napi_schedule(&rx_napi->napi);
+	}
 
 	mod_timer(&pdata->nvgro_timer,
 		  jiffies + msecs_to_jiffies(pdata->nvgro_timer_intrvl));
@@ -514,21 +558,23 @@ exit:
  * @brief ether_do_nvgro - Perform NVGRO processing.
  *
  * @param[in] pdata: Ethernet private data.
- * @param[in] napi: Ethernet driver NAPI instance.
+ * @param[in] rx_napi: Rx NAPI instance the packet is received on.
  * @param[in] skb: socket buffer
  *
  * @retval true on Success
  * @retval false on failure.
  */
 static bool ether_do_nvgro(struct ether_priv_data *pdata,
-			   struct napi_struct *napi,
+			   struct ether_rx_napi *rx_napi,
 			   struct sk_buff *skb)
 {
 	struct udphdr *uh = (struct udphdr *)(skb->data + sizeof(struct iphdr));
 	struct iphdr *iph = (struct iphdr *)skb->data;
-	struct sk_buff_head *mq = &pdata->mq;
+	struct napi_struct *napi = &rx_napi->napi;
 	struct ethhdr *ethh = eth_hdr(skb);
+	struct ether_nvgro_flow *flow;
 	struct sock *sk = NULL;
+	u32 hash;
 
 	if (ethh->h_proto != htons(ETH_P_IP))
 		return false;
@@ -536,56 +582,189 @@ static bool ether_do_nvgro(struct ether_priv_data *pdata,
 	if (iph->protocol != IPPROTO_UDP)
 		return false;
 
-	/* TODO: Hash based based queues selection */
-	/* Socket look up with IPv4/UDP source/destination */
-	sk = __udp4_lib_lookup(dev_net(skb->dev), iph->saddr, uh->source,
-			       iph->daddr, uh->dest, inet_iif(skb),
-			       inet_sdif(skb), &udp_table, NULL);
-	if (!sk)
-		return false;
-
-	/* Socket found but GRO not enabled on the socket - We don't care */
-	if (!udp_sk(sk)->gro_enabled)
+	hash = jhash_3words((__force u32)iph->saddr, (__force u32)iph->daddr,
+			    ((__force u32)uh->source << 16) |
+			    (__force u32)uh->dest, 0);
+	flow = &rx_napi->nvgro_flows[hash & (NVGRO_FLOW_BUCKETS - 1U)];
+
+	/* The socket is looked up once per segment train of a flow */
+	if (skb_queue_empty(&flow->mq) && skb_queue_empty(&flow->fq)) {
+		/* Socket look up with IPv4/UDP source/destination */
+		sk = __udp4_lib_lookup(dev_net(skb->dev), iph->saddr,
+				       uh->source, iph->daddr, uh->dest,
+				       inet_iif(skb), inet_sdif(skb),
+				       &udp_table, NULL);
+		if (!sk)
+			return false;
+
+		/* Socket found but GRO not enabled on the socket - We don't care */
+		if (!udp_sk(sk)->gro_enabled)
+			return false;
+
+		flow->saddr = iph->saddr;
+		flow->daddr = iph->daddr;
+		flow->source = uh->source;
+		flow->dest = uh->dest;
+	} else if (flow->saddr != iph->saddr || flow->daddr != iph->daddr ||
+		   flow->source != uh->source || flow->dest != uh->dest) {
+		/* Bucket is busy with another flow, leave it to the stack */
 		return false;
+	}
 
 	/* Store IPID, TTL and age of skb inside per skb control block */
 	NAPI_GRO_CB(skb)->flush_id = ntohs(iph->id);
 	NAPI_GRO_CB(skb)->free = (iph->ttl & (BIT(6) | BIT(7))) >> 6;
 	NAPI_GRO_CB(skb)->age = jiffies;
 
-	while (atomic_read(&pdata->timer_state) == OSI_ENABLE) {
-		/* busyloop */
-	};
-
-	atomic_set(&pdata->rx_state, OSI_ENABLE);
-
 	if (NAPI_GRO_CB(skb)->free == 1) {
 		/* Update final queue with first segment */
-		ether_update_fq_with_fs(pdata, skb);
+		ether_update_fq_with_fs(rx_napi, flow, skb);
 		goto exit;
 	} else {
-		if (pdata->expected_ip_id == NAPI_GRO_CB(skb)->flush_id) {
-			__skb_queue_tail(&pdata->fq, skb);
-			pdata->expected_ip_id = NAPI_GRO_CB(skb)->flush_id + 1;
+		if (flow->expected_ip_id == NAPI_GRO_CB(skb)->flush_id) {
+			__skb_queue_tail(&flow->fq, skb);
+			flow->expected_ip_id = NAPI_GRO_CB(skb)->flush_id + 1;
 
 			if (NAPI_GRO_CB(skb)->free == 2)
-				ether_gro_merge_complete(&pdata->fq, napi);
+				ether_gro_merge_complete(&flow->fq, napi);
 
 			goto exit;
 		}
 	}
 
 	/* Add skb to the queue */
-	__skb_queue_tail(mq, skb);
+	__skb_queue_tail(&flow->mq, skb);
 
 	/* Queue the packets until last segment received */
 	if (NAPI_GRO_CB(skb)->free != 2)
 		goto exit;
 
-	ether_gro(&pdata->fq, &pdata->mq, napi);
+	ether_gro(&flow->fq, &flow->mq, napi);
 
 exit:
-	atomic_set(&pdata->rx_state, OSI_DISABLE);
+	if (!skb_queue_empty(&flow->mq) || !skb_queue_empty(&flow->fq))
+		WRITE_ONCE(rx_napi->nvgro_pending, true);
+
+	return true;
+}
+#endif
+
+#ifdef ETHER_PAGE_POOL
+/**
+ * @brief Build an skb for a packet received in a page pool buffer.
+ *
+ * Algorithm:
+ * 1) Packets up to ETHER_RX_COPYBREAK are copied into the skb and the page
+ * is recycled right away.
+ * 2) For larger packets only the protocol headers are copied, the payload
+ * is attached as a page frag and the page is recycled when the skb is freed.
+ *
+ * @param[in] pdata: OSD private data structure.
+ * @param[in] napi: NAPI instance the packet is received on.
+ * @param[in] page: Page pool buffer holding the packet.
+ * @param[in] offset: Packet offset in the page.
+ * @param[in] len: Packet length.
+ * @param[in] chan: DMA Rx channel number.
+ *
+ * @retval skb on success
+ * @retval NULL on failure, the page is not consumed.
+ */
+static struct sk_buff *ether_rx_page_skb(struct ether_priv_data *pdata,
+					 struct napi_struct *napi,
+					 struct page *page, unsigned int offset,
+					 unsigned int len, unsigned int chan)
+{
+	struct page_pool *pool = pdata->page_pool[chan];
+	void *va = page_address(page) + offset;
+	unsigned int hlen = len;
+	struct sk_buff *skb;
+
+	if (len > ETHER_RX_COPYBREAK)
+		hlen = eth_get_headlen(pdata->ndev, va, ETHER_RX_COPYBREAK);
+
+	skb = napi_alloc_skb(napi, hlen);
+	if (unlikely(!skb))
+		return NULL;
+
+	skb_put_data(skb, va, hlen);
+
+	if (hlen == len) {
+		page_pool_recycle_direct(pool, page);
+		return skb;
+	}
+
+	skb_add_rx_frag(skb, 0, page, offset + hlen, len - hlen,
+			PAGE_SIZE << pool->p.order);
+#if defined(NV_SKB_MARK_FOR_RECYCLE_HAS_PAGE_POOL_ARG)
+	skb_mark_for_recycle(skb, page, pool);
+#else
+	skb_mark_for_recycle(skb);
+#endif
+
+	return skb;
+}
+
+/**
+ * @brief Run the XDP program on a packet received in a page pool buffer.
+ *
+ * Algorithm: XDP_PASS hands the, possibly adjusted, packet back to the skb
+ * path. Redirected packets are flushed at the end of the NAPI poll, all
+ * other verdicts recycle the page.
+ *
+ * @param[in] pdata: OSD private data structure.
+ * @param[in] rx_napi: Rx NAPI instance the packet is received on.
+ * @param[in] prog: XDP program.
+ * @param[in] page: Page pool buffer holding the packet.
+ * @param[in, out] offset: Packet offset in the page.
+ * @param[in, out] len: Packet length.
+ * @param[in] chan: DMA Rx channel number.
+ *
+ * @retval true if the packet was consumed by XDP
+ * @retval false if it must be passed to the stack
+ */
+static bool ether_rx_xdp(struct ether_priv_data *pdata,
+			 struct ether_rx_napi *rx_napi, struct bpf_prog *prog,
+			 struct page *page, unsigned int *offset,
+			 unsigned int *len, unsigned int chan)
+{
+	struct page_pool *pool = pdata->page_pool[chan];
+	void *va = page_address(page);
+	struct xdp_buff xdp;
+	unsigned long val;
+	u32 act;
+
+	xdp_init_buff(&xdp, PAGE_SIZE << pool->p.order, &pdata->xdp_rxq[chan]);
+	xdp_prepare_buff(&xdp, va, *offset, *len, false);
+
+	act = bpf_prog_run_xdp(prog, &xdp);
+	switch (act) {
+	case XDP_PASS:
+		*offset = xdp.data - va;
+		*len = xdp.data_end - xdp.data;
+		return false;
+	case XDP_REDIRECT:
+		if (xdp_do_redirect(pdata->ndev, &xdp, prog) == 0) {
+			rx_napi->xdp_flush = true;
+			val = pdata->xstats.xdp_redirect_n[chan];
+			pdata->xstats.xdp_redirect_n[chan] =
+				osi_update_stats_counter(val, 1UL);
+			return true;
+		}
+		break;
+	case XDP_DROP:
+		break;
+	default:
+		/* XDP_TX has no Tx ring to transmit on */
+		fallthrough;
+	case XDP_ABORTED:
+		trace_xdp_exception(pdata->ndev, prog, act);
+		break;
+	}
+
+	val = pdata->xstats.xdp_drop_n[chan];
+	pdata->xstats.xdp_drop_n[chan] = osi_update_stats_counter(val, 1UL);
+	page_pool_recycle_direct(pool, page);
+
 	return true;
 }
 #endif
@@ -597,7 +776,8 @@ exit:
  * 1) Unmap the DMA buffer address.
  * 2) Updates socket buffer with len and ether type and handover to
  * Linux network stack.
- * 3) Refill the Rx ring based on threshold.
+ *
+ * The Rx ring is refilled by OSI once the whole burst is handed over.
  *
  * @param[in] priv: OSD private data structure.
  * @param[in] rx_ring: Pointer to DMA channel Rx ring.
@@ -618,11 +798,14 @@ static void osd_receive_packet(void *priv, struct osi_rx_ring *rx_ring,
 	struct ether_rx_napi *rx_napi = pdata->rx_napi[chan];
 #ifdef ETHER_PAGE_POOL
 	struct page *page = (struct page *)rx_swcx->buf_virt_addr;
+	struct bpf_prog *xdp_prog = READ_ONCE(pdata->xdp_prog);
+	unsigned int offset = pdata->rx_headroom;
+	unsigned int len = rx_pkt_cx->pkt_len;
 	struct sk_buff *skb = NULL;
 #else
 	struct sk_buff *skb = (struct sk_buff *)rx_swcx->buf_virt_addr;
-#endif
 	dma_addr_t dma_addr = (dma_addr_t)rx_swcx->buf_phy_addr;
+#endif
 	struct net_device *ndev = pdata->ndev;
 #ifndef OSI_STRIPPED_LIB
 	struct osi_pkt_err_stats *pkt_err_stat = &pdata->osi_dma->pkt_err_stats;
@@ -639,7 +822,6 @@ static void osd_receive_packet(void *priv, struct osi_rx_ring *rx_ring,
 		rx_swcx->buf_virt_addr  = OSI_NULL;
 		rx_swcx->buf_phy_addr  = 0;
 		rx_swcx->flags |= OSI_RX_SWCX_PROCESSED;
-		ether_realloc_rx_skb(pdata, rx_ring, chan);
 		return;
 	}
 
@@ -647,8 +829,12 @@ static void osd_receive_packet(void *priv, struct osi_rx_ring *rx_ring,
 	if (likely((rx_pkt_cx->flags & OSI_PKT_CX_VALID) ==
 		   OSI_PKT_CX_VALID)) {
 #ifdef ETHER_PAGE_POOL
-		skb = netdev_alloc_skb_ip_align(pdata->ndev,
-						rx_pkt_cx->pkt_len);
+		if (xdp_prog && ether_rx_xdp(pdata, rx_napi, xdp_prog, page,
+					     &offset, &len, chan))
+			goto done;
+
+		skb = ether_rx_page_skb(pdata, &rx_napi->napi, page, offset,
+					len, chan);
 		if (unlikely(!skb)) {
 			pdata->ndev->stats.rx_dropped++;
 			dev_err(pdata->dev,
@@ -657,13 +843,6 @@ static void osd_receive_packet(void *priv, struct osi_rx_ring *rx_ring,
 			page_pool_recycle_direct(pdata->page_pool[chan], page);
 			return;
 		}
-
-		dma_sync_single_for_cpu(pdata->dev, dma_addr,
-					rx_pkt_cx->pkt_len, DMA_FROM_DEVICE);
-		skb_copy_to_linear_data(skb, page_address(page),
-					rx_pkt_cx->pkt_len);
-		skb_put(skb, rx_pkt_cx->pkt_len);
-		page_pool_recycle_direct(pdata->page_pool[chan], page);
 #else
 		skb_put(skb, rx_pkt_cx->pkt_len);
 #endif
@@ -699,9 +878,12 @@ static void osd_receive_packet(void *priv, struct osi_rx_ring *rx_ring,
 		skb->dev = ndev;
 		skb->protocol = eth_type_trans(skb, ndev);
 		ndev->stats.rx_bytes += skb->len;
+#ifdef ETHER_DIM
+		rx_napi->dim_bytes += skb->len;
+#endif
 #ifdef ETHER_NVGRO
 		if ((ndev->features & NETIF_F_GRO) &&
-		    ether_do_nvgro(pdata, &rx_napi->napi, skb))
+		    ether_do_nvgro(pdata, rx_napi, skb))
 			goto done;
 #endif
 		if (likely(ndev->features & NETIF_F_GRO)) {
@@ -722,7 +904,7 @@ static void osd_receive_packet(void *priv, struct osi_rx_ring *rx_ring,
 		dev_kfree_skb_any(skb);
 	}
 
-#ifdef ETHER_NVGRO
+#if defined(ETHER_NVGRO) || defined(ETHER_PAGE_POOL)
 done:
 #endif
 	ndev->stats.rx_packets++;
@@ -730,9 +912,53 @@ done:
 	rx_swcx->buf_phy_addr = 0;
 	/* mark packet is processed */
 	rx_swcx->flags |= OSI_RX_SWCX_PROCESSED;
+}
+
+/**
+ * @brief Handover a burst of received packets to network stack.
+ *
+ * Algorithm:
+ * 1) Make the valid packet buffers of the burst CPU visible and prefetch
+ * their headers, so they are in cache by the time each packet is parsed.
+ * 2) Handover the packets one by one to network stack.
+ *
+ * @param[in] priv: OSD private data structure.
+ * @param[in] rx_ring: Pointer to DMA channel Rx ring.
+ * @param[in] chan: DMA Rx channel number.
+ * @param[in] dma_buf_len: Rx DMA buffer length.
+ * @param[in] rx_pkt_cx: Received packet contexts of the burst.
+ * @param[in] rx_swcx: Received packet sw contexts of the burst.
+ * @param[in] count: Number of packets in the burst.
+ */
+static void osd_receive_packets(void *priv, struct osi_rx_ring *rx_ring,
+				unsigned int chan, unsigned int dma_buf_len,
+				const struct osi_rx_pkt_cx *rx_pkt_cx,
+				struct osi_rx_swcx *const *rx_swcx,
+				unsigned int count)
+{
+	struct ether_priv_data *pdata = (struct ether_priv_data *)priv;
+	unsigned int i;
 
-	if (osi_get_refill_rx_desc_cnt(pdata->osi_dma, chan) >= 16U)
-		ether_realloc_rx_skb(pdata, rx_ring, chan);
+	for (i = 0; i < count; i++) {
+		if (((rx_pkt_cx[i].flags & OSI_PKT_CX_VALID) !=
+		     OSI_PKT_CX_VALID) ||
+		    (rx_swcx[i]->buf_virt_addr == pdata->resv_buf_virt_addr))
+			continue;
+#ifdef ETHER_PAGE_POOL
+		dma_sync_single_for_cpu(pdata->dev,
+					(dma_addr_t)rx_swcx[i]->buf_phy_addr,
+					rx_pkt_cx[i].pkt_len, DMA_FROM_DEVICE);
+		net_prefetch(page_address((struct page *)
+					  rx_swcx[i]->buf_virt_addr) +
+			     pdata->rx_headroom);
+#else
+		prefetchw(rx_swcx[i]->buf_virt_addr);
+#endif
+	}
+
+	for (i = 0; i < count; i++)
+		osd_receive_packet(priv, rx_ring, chan, dma_buf_len,
+				   &rx_pkt_cx[i], rx_swcx[i]);
 }
 
 /**
@@ -803,6 +1029,10 @@ static void osd_transmit_complete(void *priv, const struct osi_tx_swcx *swcx,
 		}
 
 		ndev->stats.tx_packets++;
+#ifdef ETHER_DIM
+		pdata->tx_napi[chan]->dim_pkts++;
+		pdata->tx_napi[chan]->dim_bytes += skb->len;
+#endif
 		if ((txdone_pkt_cx->flags & OSI_TXDONE_CX_TS_DELAYED) ==
 		    OSI_TXDONE_CX_TS_DELAYED) {
 			add_skb_node(pdata, skb, txdone_pkt_cx->pktid);
@@ -932,7 +1162,7 @@ void ether_assign_osd_ops(struct osi_core_priv_data *osi_core,
 #endif
 	osi_core->osd_ops.restart_lane_bringup = osd_restart_lane_bringup;
 	osi_dma->osd_ops.transmit_complete = osd_transmit_complete;
-	osi_dma->osd_ops.receive_packet = osd_receive_packet;
+	osi_dma->osd_ops.receive_packets = osd_receive_packets;
 	osi_dma->osd_ops.realloc_buf = osd_realloc_buf;
 	osi_dma->osd_ops.ops_log = osd_log;
 	osi_dma->osd_ops.udelay = osd_udelay;
@@ -3,6 +3,8 @@
 
 #include "ether_linux.h"
 #include "macsec.h"
+#include <linux/rtnetlink.h>
+#include <linux/sched/signal.h>
 
 #if (IS_ENABLED(CONFIG_TEGRA_HSIERRRPTINJ))
 #include <linux/tegra-hsierrrptinj.h>
@@ -2490,9 +2492,14 @@ static ssize_t ether_nvgro_stats_show(struct device *dev,
 {
 	struct net_device *ndev = (struct net_device *)dev_get_drvdata(dev);
 	struct ether_priv_data *pdata = netdev_priv(ndev);
+	struct osi_dma_priv_data *osi_dma = pdata->osi_dma;
+	u64 dropped = 0;
+	unsigned int i;
 
-	return scnprintf(buf, PAGE_SIZE, "dropped = %llu\n",
-			 pdata->nvgro_dropped);
+	for (i = 0; i < osi_dma->num_dma_chans; i++)
+		dropped += pdata->rx_napi[osi_dma->dma_chans[i]]->nvgro_dropped;
+
+	return scnprintf(buf, PAGE_SIZE, "dropped = %llu\n", dropped);
 }
 
 /**
@@ -2505,6 +2512,10 @@ static DEVICE_ATTR(nvgro_stats, 0644,
 /**
  * @brief Dumps NVGRO queues.
  *
+ * Algorithm: The queues are owned by the Rx NAPI of each channel, so
+ * every NAPI is disabled while its queues are walked. rtnl keeps the
+ * interface from going down meanwhile.
+ *
  * @param[in] dev: Device data.
  * @param[in] attr: Device attribute
  * @param[in] buf: Buffer to store the current ptp sync method
@@ -2515,22 +2526,54 @@ static ssize_t ether_nvgro_dump_show(struct device *dev,
 {
 	struct net_device *ndev = (struct net_device *)dev_get_drvdata(dev);
 	struct ether_priv_data *pdata = netdev_priv(ndev);
+	struct osi_dma_priv_data *osi_dma = pdata->osi_dma;
+	struct ether_rx_napi *rx_napi;
+	struct ether_nvgro_flow *flow;
 	struct sk_buff *p, *pp;
 	char *start = buf;
+	unsigned int i, j;
+
+	/* sysfs removal may run under rtnl, don't block on it */
+	if (!rtnl_trylock())
+		return restart_syscall();
 
-	buf += scnprintf(buf, PAGE_SIZE, "MQ: ");
-	skb_queue_walk_safe(&pdata->mq, p, pp) {
-		buf += scnprintf(buf, PAGE_SIZE, "skb %p TTL %d IPID %u\n",
-				 p, NAPI_GRO_CB(p)->free,
-				 NAPI_GRO_CB(p)->flush_id);
+	if (!netif_running(ndev)) {
+		rtnl_unlock();
+		return 0;
 	}
 
-	buf += scnprintf(buf, PAGE_SIZE, "FQ: ");
-	skb_queue_walk_safe(&pdata->fq, p, pp) {
-		buf += scnprintf(buf, PAGE_SIZE, "skb %p TTL %d IPID %u\n",
-				 p, NAPI_GRO_CB(p)->free,
-				 NAPI_GRO_CB(p)->flush_id);
+	for (i = 0; i < osi_dma->num_dma_chans; i++) {
+		rx_napi = pdata->rx_napi[osi_dma->dma_chans[i]];
+		napi_disable(&rx_napi->napi);
+
+		for (j = 0; j < NVGRO_FLOW_BUCKETS; j++) {
+			flow = &rx_napi->nvgro_flows[j];
+			if (skb_queue_empty(&flow->mq) &&
+			    skb_queue_empty(&flow->fq))
+				continue;
+
+			buf += scnprintf(buf, PAGE_SIZE - (buf - start),
+					 "chan %u flow %u MQ: ",
+					 osi_dma->dma_chans[i], j);
+			skb_queue_walk_safe(&flow->mq, p, pp) {
+				buf += scnprintf(buf, PAGE_SIZE - (buf - start),
+						 "skb %p TTL %d IPID %u\n",
+						 p, NAPI_GRO_CB(p)->free,
+						 NAPI_GRO_CB(p)->flush_id);
+			}
+
+			buf += scnprintf(buf, PAGE_SIZE - (buf - start), "FQ: ");
+			skb_queue_walk_safe(&flow->fq, p, pp) {
+				buf += scnprintf(buf, PAGE_SIZE - (buf - start),
+						 "skb %p TTL %d IPID %u\n",
+						 p, NAPI_GRO_CB(p)->free,
+						 NAPI_GRO_CB(p)->flush_id);
+			}
+		}
+
+		napi_enable(&rx_napi->napi);
 	}
+	rtnl_unlock();
 
 	return (buf - start);
 }
@@ -148,6 +148,14 @@ struct camera_common_frmfmt {
 	int	mode;
 };
 
+/* frmfmt[] lookup entry, one per distinct frame size */
+struct camera_common_fmt_index {
+	u32	width;
+	u32	height;
+	int	idx;		/* first frmfmt[] entry of this size */
+	int	hdr_idx;	/* first hdr_en entry of this size, -1 if none */
+};
+
 struct camera_common_colorfmt {
 	unsigned int			code;
 	enum v4l2_colorspace		colorspace;
@@ -243,6 +251,9 @@ struct tegracam_ctrl_ops {
 			struct sensor_blob *blob, bool val);
 };
 
+/* TEGRA_CAMERA_CID_BASE offsets covered by the control index */
+#define TEGRACAM_CID_INDEX_SIZE		256
+
 struct tegracam_ctrl_handler {
 	struct v4l2_ctrl_handler	ctrl_handler;
 	const struct tegracam_ctrl_ops	*ctrl_ops;
@@ -251,6 +262,8 @@ struct tegracam_ctrl_handler {
 
 	int				numctrls;
 	struct v4l2_ctrl		*ctrls[MAX_CID_CONTROLS];
+	/* ctrls[] position + 1 by cid offset, 0 when not registered */
+	u8				cid_index[TEGRACAM_CID_INDEX_SIZE];
 };
 
 struct camera_common_data {
@@ -258,6 +271,8 @@ struct camera_common_data {
 	struct v4l2_ctrl_handler		*ctrl_handler;
 	struct device				*dev;
 	const struct camera_common_frmfmt	*frmfmt;
+	/* frmfmt[] sorted by size, NULL falls back to a linear scan */
+	struct camera_common_fmt_index		*fmt_index;
 	const struct camera_common_colorfmt	*colorfmt;
 	struct dentry				*debugdir;
 	struct camera_common_power_rail		*power;
@@ -285,6 +300,8 @@ struct camera_common_data {
 	int	mode;
 	int 	mode_prop_idx;
 	int	numfmts;
+	int	num_fmt_index;
+	bool	has_hdr_fmts;
 	int 	blklvl_max_range;
 	int 	dig_gain_def_value;
 	int 	dig_gain_max_range;
@@ -398,6 +415,7 @@ int camera_common_get_framesync(struct v4l2_subdev *sd,
 int camera_common_initialize(struct camera_common_data *s_data,
 		const char *dev_name);
 void camera_common_cleanup(struct camera_common_data *s_data);
+int camera_common_build_fmt_index(struct camera_common_data *s_data);
 
 /* Focuser */
 int camera_common_focuser_init(struct camera_common_focuser_data *s_data);
@@ -410,6 +428,9 @@ const struct camera_common_colorfmt *camera_common_find_pixelfmt(
 int tegracam_ctrl_synchronize_ctrls(struct tegracam_ctrl_handler *handler);
 int tegracam_ctrl_set_overrides(struct tegracam_ctrl_handler *handler);
 int tegracam_ctrl_handler_init(struct tegracam_ctrl_handler *handler);
+void tegracam_ctrl_build_index(struct tegracam_ctrl_handler *handler);
+struct v4l2_ctrl *tegracam_find_ctrl(struct tegracam_ctrl_handler *handler,
+		u32 cid);
 int tegracam_init_ctrl_ranges(struct tegracam_ctrl_handler *handler);
 int tegracam_init_ctrl_ranges_by_mode(
 		struct tegracam_ctrl_handler *handler,
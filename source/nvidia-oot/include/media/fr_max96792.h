@@ -36,6 +36,10 @@ int max96792_gmsl_setup(struct device *dev);
 
 int max96792_xvs_setup(struct device *dev, bool direction);
 
+void max96792_serdes_lock(struct device *dev);
+
+void max96792_serdes_unlock(struct device *dev);
+
 enum {
 	max96792_OUT,
 	max96792_IN,
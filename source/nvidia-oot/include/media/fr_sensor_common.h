@@ -48,6 +48,84 @@ typedef enum {
 	NEW,
 } v4l2_ctrl_value;
 
+/* Pixel depth columns of the per-sensor data rate tables */
+enum {
+	FR_BPP_8,
+	FR_BPP_10,
+	FR_BPP_12,
+	FR_BPP_16,
+	FR_NUM_BPP,
+};
+
+/* CSI lane count columns of the per-sensor data rate tables */
+enum {
+	FR_LANES_1,
+	FR_LANES_2,
+	FR_LANES_4,
+	FR_NUM_LANES,
+};
+
+/* Index of a [data rate][bpp][lanes] table entry */
+struct fr_rate_key {
+	u32 rate;
+	u32 bpp;
+	u32 lanes;
+};
+
+/* I2C accounting of mode table writes done during one set_mode */
+struct fr_table_stats {
+	ktime_t start;
+	u32 regs;
+	u32 skipped;
+	u32 xfers;
+	u32 sleep_ms;
+};
+
+/* Stream stop timing, the frame drain is waited for lazily */
+struct fr_stop_ctx {
+	ktime_t start;
+	ktime_t settle;		/* stopped frame has drained, 0 if settled */
+	u32 last_us;		/* stop_streaming and drain wait duration */
+	u32 max_us;
+	u32 settle_us;		/* total time slept waiting for the drain */
+	struct dentry *debugfs_dir;
+};
+
+/* Coalesced register run of a compiled mode table, len 0 marks a sleep */
+struct fr_reg_run {
+	u16 addr;
+	u16 len;
+	u32 val;	/* payload offset, or sleep time in ms */
+};
+
+/* Mode table precompiled into a run list and a packed payload */
+struct fr_table_blob {
+	const struct reg_8 *table;
+	const struct fr_reg_run *runs;
+	const u8 *payload;
+	u32 num_runs;
+};
+
+struct fr_table_cache {
+	struct fr_table_blob *blobs;
+	u32 num_blobs;
+	bool synced;	/* regcache matches the sensor since power on */
+	bool diff;	/* set_mode in progress writes only changed registers */
+};
+
+/* Per-frame control blob state of a FRAMOS sensor */
+struct fr_ctrl_blob {
+	struct sensor_blob *blob;	/* buffered writes are packetized here */
+	bool hold;			/* group hold is open in the blob */
+};
+
+/* Control values latched at the start of set_mode */
+struct fr_ctrl_snapshot {
+	s64 operation_mode;
+	s64 sync_mode;
+	s64 test_pattern;
+};
+
 void fr_calc_lshift(u64 *val, u8 *lshift, s64 max);
 
 s64 fr_get_v4l2_ctrl_value(struct tegracam_device *tc_dev,
@@ -56,11 +134,20 @@ s64 fr_get_v4l2_ctrl_value(struct tegracam_device *tc_dev,
 void fr_update_ctrl_range(struct tegracam_device *tc_dev,
 					int ctrl_id, u64 min, u64 max);
 
+int fr_rate_key_init(struct fr_rate_key *key, u32 num_rates, s64 rate,
+					u32 code, u32 numlanes);
+
+int fr_rate_key_get(struct tegracam_device *tc_dev, u32 num_rates,
+					struct fr_rate_key *key);
+
 void fr_gpio_set(struct camera_common_data *s_data,
 						unsigned int gpio, int val);
 
 struct v4l2_ctrl *fr_find_v4l2_ctrl(struct tegracam_device *tc_dev, int ctrl_id);
 
+void fr_ctrl_snapshot_take(struct tegracam_device *tc_dev,
+				struct fr_ctrl_snapshot *snap);
+
 void fr_get_gpio_ctrl(struct camera_common_pdata *board_priv_pdata);
 
 int cam_gpio_register(struct device *dev, unsigned int pin_num);
@@ -74,4 +161,59 @@ int common_get_broadcast_client(struct tegracam_device *tc_dev,
 			struct v4l2_ctrl *ctrl,
 			const struct regmap_config *sensor_regmap_config);
 
+int fr_write_table_8(struct regmap *regmap, const struct reg_8 table[],
+		u16 wait_ms_addr, u16 end_addr, struct fr_table_stats *stats);
+
+int fr_table_cache_add(struct device *dev, struct fr_table_cache *cache,
+			const struct reg_8 * const tables[], u32 num_tables,
+			u16 wait_ms_addr, u16 end_addr);
+
+int fr_write_table_cached(struct regmap *regmap,
+		const struct fr_table_cache *cache, const struct reg_8 table[],
+		u16 wait_ms_addr, u16 end_addr, struct fr_table_stats *stats);
+
+void fr_table_cache_invalidate(struct regmap *regmap,
+					struct fr_table_cache *cache);
+
+void fr_table_cache_begin_mode(struct fr_table_cache *cache);
+
+void fr_table_cache_end_mode(struct fr_table_cache *cache);
+
+void fr_table_stats_begin(struct fr_table_stats *stats);
+
+void fr_table_stats_end(struct device *dev, struct fr_table_stats *stats,
+								int mode);
+
+void fr_stream_stop_begin(struct fr_stop_ctx *ctx);
+
+void fr_stream_stop_end(struct fr_stop_ctx *ctx, u64 frame_us);
+
+void fr_stream_settle(struct fr_stop_ctx *ctx);
+
+void fr_stop_debugfs_init(struct device *dev, struct fr_stop_ctx *ctx);
+
+void fr_stop_debugfs_remove(struct fr_stop_ctx *ctx);
+
+int fr_write_buffered_reg(struct camera_common_data *s_data,
+		struct regmap *regmap, u16 hold_addr, u16 addr_low,
+		u8 num_regs, u64 val, bool msb_first);
+
+int fr_read_buffered_reg(struct camera_common_data *s_data,
+		struct regmap *regmap, u16 hold_addr, u16 addr_low,
+		u8 num_regs, u64 *val, bool msb_first);
+
+void fr_select_ctrl_ops(struct tegracam_ctrl_ops *ops,
+			const struct tegracam_ctrl_ops *tmpl);
+
+int fr_set_group_hold_ex(struct fr_ctrl_blob *ctrl_blob,
+			struct sensor_blob *blob, u16 hold_addr, bool val);
+
+int fr_set_ctrl_ex(struct tegracam_device *tc_dev,
+		struct fr_ctrl_blob *ctrl_blob, struct sensor_blob *blob,
+		int (*set_ctrl)(struct tegracam_device *tc_dev, s64 val),
+		s64 val);
+
+int fr_blob_buffered_reg(struct fr_ctrl_blob *ctrl_blob, u16 hold_addr,
+			u16 addr_low, u8 num_regs, u64 val, bool msb_first);
+
 #endif
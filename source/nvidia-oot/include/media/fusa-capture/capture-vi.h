@@ -14,7 +14,9 @@
 
 #if defined(__KERNEL__)
 #include <linux/compiler.h>
+#include <linux/spinlock.h>
 #include <linux/types.h>
+#include <linux/wait.h>
 #else
 #include <stdint.h>
 #endif
@@ -75,6 +77,17 @@ struct vi_capture {
 		 * Completion for capture requests (frame), if progress status
 		 * notifier is not in use
 		 */
+	unsigned long *requests_done;
+		/**<
+		 * Bitmap of capture descriptors whose status has been written
+		 * back by RCE and not yet consumed
+		 */
+	wait_queue_head_t status_wait;
+		/**< Wait queue for @a requests_done updates */
+	spinlock_t notify_lock; /**< Lock for @a status_notify */
+	void (*status_notify)(void *data, uint32_t buffer_index);
+		/**< Kernel client callback for capture descriptor completion */
+	void *status_notify_data; /**< Argument of @a status_notify */
 	struct mutex control_msg_lock;
 		/**< Lock for capture-control IVC control_resp_msg */
 	struct CAPTURE_CONTROL_MSG control_resp_msg;
@@ -439,6 +452,60 @@ int vi_capture_status(
 	struct tegra_vi_channel *chan,
 	int32_t timeout_ms);
 
+/**
+ * @brief Check and consume the completion of a single capture descriptor.
+ *
+ * Unlike @ref vi_capture_status(), completions are tracked per descriptor, so
+ * frames which have already finished can be drained in any order without
+ * sleeping.
+ *
+ * This is a non-blocking call.
+ *
+ * @param[in]	chan		VI channel context
+ * @param[in]	buffer_index	Capture descriptor index
+ *
+ * @returns	true if the descriptor status has been written back
+ */
+bool vi_capture_status_done(
+	struct tegra_vi_channel *chan,
+	uint32_t buffer_index);
+
+/**
+ * @brief Wait on the capture status of a single capture descriptor and
+ *	  consume it.
+ *
+ * This is a blocking call, with the possibility of timeout. It returns
+ * without sleeping if the descriptor has already completed.
+ *
+ * @param[in]	chan		VI channel context
+ * @param[in]	buffer_index	Capture descriptor index
+ * @param[in]	timeout_ms	Time to wait for status completion [ms], set to
+ *				a negative value for indefinite
+ *
+ * @returns	0 (success), neg. errno (failure)
+ */
+int vi_capture_status_wait(
+	struct tegra_vi_channel *chan,
+	uint32_t buffer_index,
+	int32_t timeout_ms);
+
+/**
+ * @brief Register a kernel client callback for capture completion.
+ *
+ * The callback is invoked from the IVC receive context once the status of a
+ * capture descriptor has been written back, before it is consumed with
+ * @ref vi_capture_status_wait(). It must not sleep. The callback is dropped
+ * by @ref vi_capture_release().
+ *
+ * @param[in]	chan	VI channel context
+ * @param[in]	notify	Completion callback, NULL to unregister
+ * @param[in]	data	Argument passed to @a notify
+ */
+void vi_capture_set_status_notify(
+	struct tegra_vi_channel *chan,
+	void (*notify)(void *data, uint32_t buffer_index),
+	void *data);
+
 /**
  * @brief Setup VI channel capture status progress notifier.
  *
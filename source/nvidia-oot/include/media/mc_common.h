@@ -21,6 +21,7 @@
 #include <media/tegra_camera_core.h>
 #include <media/csi.h>
 #include <linux/workqueue.h>
+#include <linux/kfifo.h>
 #include <linux/semaphore.h>
 #include <linux/rwsem.h>
 #include <linux/version.h>
@@ -34,10 +35,21 @@
 
 #define CAPTURE_MIN_BUFFERS	1U
 #define CAPTURE_MAX_BUFFERS	240U
+/* power of two holding every capture buffer */
+#define CAPTURE_RING_SIZE	256U
 
 #define TEGRA_MEM_FORMAT 0
 #define TEGRA_ISP_FORMAT 1
 
+#define TEGRA_LATENCY_BUCKETS	20
+
+enum tegra_channel_latency {
+	TEGRA_LATENCY_SOF_EOF = 0,
+	TEGRA_LATENCY_EOF_DEQUEUE,
+	TEGRA_LATENCY_DEQUEUE_DONE,
+	TEGRA_LATENCY_NUM,
+};
+
 enum channel_capture_state {
 	CAPTURE_IDLE = 0,
 	CAPTURE_GOOD,
@@ -64,6 +76,8 @@ enum interlaced_type {
  * @vb2_state: V4L2 buffer state (active, done, error)
  * @capture_descr_index: Index into the VI capture descriptor queue
  * @addr: Tegra IOVA buffer address for VI output
+ * @emb_hdr_version: stream for which the embedded data header was written
+ * @emb_hdr_addr: buffer address at which the embedded data header was written
  */
 struct tegra_channel_buffer {
 	struct vb2_v4l2_buffer buf;
@@ -78,11 +92,32 @@ struct tegra_channel_buffer {
 	u32 thresh[TEGRA_CSI_BLOCKS];
 	int version;
 	int state;
+
+	unsigned int emb_hdr_version;
+	dma_addr_t emb_hdr_addr;
+
+	u64 dequeue_ns;
 };
 
 #define to_tegra_channel_buffer(vb) \
 	container_of(vb, struct tegra_channel_buffer, buf)
 
+/**
+ * struct tegra_channel_stats - capture latency and frame loss statistics
+ * @hist: latency histograms, bucket n counts [2^(n-1), 2^n) us
+ * @drops: frames missing from the captured frame id sequence
+ * @errors: buffers returned to the application in error state
+ * @last_frame_id: frame id of the last successfully captured frame
+ * @frame_id_valid: @last_frame_id is set for the current stream
+ */
+struct tegra_channel_stats {
+	u32 hist[TEGRA_LATENCY_NUM][TEGRA_LATENCY_BUCKETS];
+	u32 drops;
+	u32 errors;
+	u32 last_frame_id;
+	bool frame_id_valid;
+};
+
 /**
  * struct tegra_vi_graph_entity - Entity in the video graph
  * @list: list entry in a graph entities list
@@ -184,6 +219,9 @@ struct tegra_channel {
 	unsigned int capture_descr_index;
 	unsigned int capture_descr_sequence;
 	unsigned int capture_reqs_enqueued;
+	unsigned int capture_depth_hint;
+	unsigned int capture_starved;
+	unsigned int capture_frames;
 	struct task_struct *kthread_capture_start;
 	struct task_struct *kthread_release;
 	wait_queue_head_t start_wait;
@@ -195,10 +233,9 @@ struct tegra_channel {
 	bool init_done;
 	struct list_head capture;
 	struct list_head release;
-	struct list_head dequeue;
+	DECLARE_KFIFO(dequeue, struct tegra_channel_buffer *, CAPTURE_RING_SIZE);
 	spinlock_t start_lock;
 	spinlock_t release_lock;
-	spinlock_t dequeue_lock;
 	struct work_struct status_work;
 	struct work_struct error_work;
 
@@ -252,6 +289,8 @@ struct tegra_channel {
 	struct tegra_vi_channel *tegra_vi_channel[TEGRA_CSI_BLOCKS];
 	struct capture_descriptor *request[TEGRA_CSI_BLOCKS];
 	dma_addr_t request_iova[TEGRA_CSI_BLOCKS];
+	/* vb2 buffer index of each capture descriptor */
+	u8 request_vb2_index[CAPTURE_MAX_BUFFERS];
 
 	bool is_slvsec;
 	int is_interlaced;
@@ -264,6 +303,24 @@ struct tegra_channel {
 	dma_addr_t emb_buf;
 	void *emb_buf_addr;
 	unsigned int emb_buf_size;
+	unsigned int emb_hdr_version;
+
+	struct dentry *debugdir;
+	u32 fast_recoveries;
+	u32 fast_recover_seq;
+	u32 full_recoveries;
+	struct tegra_channel_stats stats;
+	spinlock_t stats_lock;
+	u32 tsc_rate;
+
+	unsigned int sync_group;
+	struct tegra_channel_sync_group *sync_grp;
+	struct list_head sync_entry;
+	struct tegra_channel_buffer *sync_buf;
+	u32 sync_matched;
+	u32 sync_unmatched;
+	u32 sync_drift_us;
+	u32 sync_drift_max_us;
 };
 
 #define to_tegra_channel(vdev) \
@@ -383,8 +440,13 @@ void tegra_channel_ring_buffer(struct tegra_channel *chan,
 			       struct timespec64 *ts, int state);
 struct tegra_channel_buffer *dequeue_buffer(struct tegra_channel *chan,
 	bool requeue);
+void enqueue_dequeue_buffer(struct tegra_channel *chan,
+	struct tegra_channel_buffer *buf);
 struct tegra_channel_buffer *dequeue_dequeue_buffer(struct tegra_channel *chan);
 int tegra_channel_error_recover(struct tegra_channel *chan, bool queue_error);
+void tegra_channel_stats_latency(struct tegra_channel *chan,
+	enum tegra_channel_latency type, s64 ns);
+void tegra_channel_stats_frame(struct tegra_channel *chan, u32 frame_id);
 int tegra_channel_alloc_buffer_queue(struct tegra_channel *chan,
 					unsigned int num_buffers);
 void tegra_channel_dealloc_buffer_queue(struct tegra_channel *chan);
@@ -9,6 +9,7 @@
 #define __TEGRA_V4L2_CAMERA__
 
 #include <linux/v4l2-controls.h>
+#include <linux/videodev2.h>
 
 #define TEGRA_CAMERA_CID_BASE	(V4L2_CTRL_CLASS_CAMERA | 0x2000)
 
@@ -62,6 +63,7 @@
 #define TEGRA_CAMERA_CID_FLIP_MIRROR                (TEGRA_CAMERA_CID_BASE+121)
 #define TEGRA_CAMERA_CID_SHUTTER_MODE               (TEGRA_CAMERA_CID_BASE+122)
 #define TEGRA_CAMERA_CID_XVS_XHS_STATE              (TEGRA_CAMERA_CID_BASE+123)
+#define TEGRA_CAMERA_CID_VI_SYNC_GROUP              (TEGRA_CAMERA_CID_BASE+124)
 
 /* Sensor specific controls */
 
@@ -86,6 +88,23 @@
  */
 #define TEGRA_CAMERA_CID_SENSOR_MODES		(TEGRA_CAMERA_CID_BASE + 130)
 
+#define TEGRA_CAMERA_EVENT_BASE		(V4L2_EVENT_PRIVATE_START | 0x2000)
+
+/* Capture completion, raised before the buffer can be dequeued */
+#define TEGRA_CAMERA_EVENT_FRAME_DONE		(TEGRA_CAMERA_EVENT_BASE+0)
+
+/* TEGRA_CAMERA_EVENT_FRAME_DONE payload in v4l2_event.u.data */
+struct tegra_camera_frame_done {
+	__u32 index;		/* V4L2 buffer index */
+	__u32 sequence;		/* capture request sequence */
+	__u32 frame_id;		/* frame number from the sensor */
+	__u32 status;		/* CAPTURE_STATUS_* code */
+	__u64 sof_timestamp;	/* ns, same clock as the buffer timestamp */
+	__u64 eof_timestamp;
+	__u32 flags;		/* CAPTURE_STATUS_FLAG_* */
+	__u32 err_data;
+};
+
 #define MAX_BUFFER_SIZE			32
 #define MAX_CID_CONTROLS		32
 #define MAX_NUM_SENSOR_MODES		30
@@ -101,6 +101,23 @@ TRACE_EVENT(tegra_channel_capture_setup,
 		  __entry->format)
 );
 
+TRACE_EVENT(tegra_channel_capture_enqueue,
+	TP_PROTO(unsigned int index, unsigned int sequence, u64 setup_ns),
+	TP_ARGS(index, sequence, setup_ns),
+	TP_STRUCT__entry(
+		__field(unsigned int,	index)
+		__field(unsigned int,	sequence)
+		__field(u64,		setup_ns)
+	),
+	TP_fast_assign(
+		__entry->index = index;
+		__entry->sequence = sequence;
+		__entry->setup_ns = setup_ns;
+	),
+	TP_printk("descr %u seq %u setup %llu ns",
+		  __entry->index, __entry->sequence, __entry->setup_ns)
+);
+
 DECLARE_EVENT_CLASS(frame,
 	TP_PROTO(const char *str, struct timespec64 *ts),
 	TP_ARGS(str, ts),
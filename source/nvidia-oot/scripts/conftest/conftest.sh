@@ -7042,6 +7042,23 @@ compile_test() {
             compile_check_conftest "$CODE" "NV_NETIF_SET_TSO_MAX_SIZE_PRESENT" "" "functions"
         ;;
 
+        net_dim_has_sample_ptr_arg)
+            #
+            # Determine if net_dim() takes a pointer to the dim_sample.
+            #
+            # The end sample is passed by reference since Linux v6.13,
+            # earlier kernels pass the struct dim_sample by value.
+            #
+            CODE="
+            #include <linux/dim.h>
+            void conftest_net_dim_has_sample_ptr_arg(struct dim *dim,
+                                                     struct dim_sample *sample) {
+                    net_dim(dim, sample);
+            }"
+
+            compile_check_conftest "$CODE" "NV_NET_DIM_HAS_SAMPLE_PTR_ARG" "" "types"
+        ;;
+
         netif_napi_add_weight)
             #
             # Determine if netif_napi_add_weight() function is present
@@ -7291,6 +7308,27 @@ compile_test() {
             compile_check_conftest "$CODE" "NV_SHRINKER_ALLOC_PRESENT" "" "functions"
         ;;
 
+        skb_mark_for_recycle_has_page_pool_arg)
+            #
+            # Determine if skb_mark_for_recycle() takes the page and the
+            # page_pool as well as the skb.
+            #
+            # The page and page_pool arguments of the first version of
+            # skb_mark_for_recycle() were dropped in later kernels, as the
+            # page_pool is found through the page.
+            #
+            CODE="
+            #include <linux/skbuff.h>
+            void conftest_skb_mark_for_recycle_has_page_pool_arg(
+                struct sk_buff *skb,
+                struct page *page,
+                struct page_pool *pp) {
+                    skb_mark_for_recycle(skb, page, pp);
+            }"
+
+            compile_check_conftest "$CODE" "NV_SKB_MARK_FOR_RECYCLE_HAS_PAGE_POOL_ARG" "" "types"
+        ;;
+
         snd_soc_card_jack_new_has_no_snd_soc_jack_pins)
             #
             # Determine if the function snd_soc_card_jack_new() has 'pins' and